@@ -0,0 +1,133 @@
+/*
+ * File:   bam.c
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 3:10 PM
+ */
+
+#include <p18f8722.h>
+
+#include "bam.h"
+
+
+/* PR4 and T4CON for each bit period, BAM_UNIT = 24 counts
+ * bits 0..3: 24, 48, 96, 192 counts    => PR4 = counts-1, postscaler 1:1
+ * bits 4..7: 384..3072 counts          => PR4 = 192-1, postscaler 1:2..1:16
+ * T4CON = 0 OOOO 1 01 => postscaler OOOO, TMR4ON, prescaler 1:4
+ */
+const unsigned char BamPr[8] =
+{
+    24-1, 48-1, 96-1, 192-1, 192-1, 192-1, 192-1, 192-1
+};
+
+const unsigned char BamT4con[8] =
+{
+    0b00000101, /* 1:1  */
+    0b00000101, /* 1:1  */
+    0b00000101, /* 1:1  */
+    0b00000101, /* 1:1  */
+    0b00001101, /* 1:2  */
+    0b00011101, /* 1:4  */
+    0b00111101, /* 1:8  */
+    0b01111101  /* 1:16 */
+};
+
+unsigned char bamMask[2][8];        /* port mask per bit, front and back buffer */
+unsigned char bamWork[8];           /* masks built by BamSetDuty() */
+volatile unsigned char bamFront = 0;        /* buffer shown by the ISR */
+volatile unsigned char bamPending = 0;      /* back buffer is ready, swap at frame start */
+unsigned char bamBit = 0;           /* bit period shown now */
+
+
+
+/*******************************************************************************
+ * Init BAM Function
+ */
+void BamInit(void)
+{
+    unsigned char i;
+
+    for (i = 0; i < 8; i++)
+    {
+        bamMask[0][i] = 0;
+        bamMask[1][i] = 0;
+        bamWork[i] = 0;
+    }
+
+    LATD = LATD & ~BAM_PORT_MASK;
+    TRISD = TRISD & ~BAM_PORT_MASK;
+
+// START - TMR4 setup
+    bamBit = 0;
+    TMR4 = 0;
+    PR4 = BamPr[0];
+    T4CON = BamT4con[0] & ~0b00000100; // same setting, timer still OFF
+    TMR4IF = 0;
+    TMR4IE = 1;                 // enable TMR4 match interrupts
+    PEIE = 1;                   // enable peripheral interrupts
+    T4CONbits.TMR4ON = 1;       // timer ON
+// END - TMR4 setup
+} /* void BamInit(void) */
+
+
+
+/*******************************************************************************
+ * Set BAM Duty Function
+ *  - ch: PORTD pin 0..7
+ *  - duty: 0 = OFF .. 255 = ON
+ *  - applied at the start of the next frame
+ */
+void BamSetDuty(unsigned char ch, unsigned char duty)
+{
+    unsigned char i;
+    unsigned char pin = 1 << ch;
+    unsigned char back;
+
+    /* bit i of the duty goes to the mask of period i */
+    for (i = 0; i < 8; i++)
+    {
+        if (duty & 1)
+            bamWork[i] |= pin;
+        else
+            bamWork[i] &= ~pin;
+        duty >>= 1;
+    }
+
+    /* the ISR must not swap while the back buffer is copied */
+    bamPending = 0;
+    back = !bamFront;
+    for (i = 0; i < 8; i++)
+        bamMask[back][i] = bamWork[i];
+    bamPending = 1;
+} /* void BamSetDuty(unsigned char ch, unsigned char duty) */
+
+
+
+/*******************************************************************************
+ * BAM Interrupt Function
+ *  - call it first in the interrupt service routine, bit 0 is only 38.4us long
+ */
+void BamIsr(void)
+{
+    if (TMR4IE && TMR4IF)
+    {
+        TMR4IF = 0;     // clear interrupt flag
+
+        /* TMR4 restarted from 0 at the match, load the next bit period */
+#if (BAM_PORT_MASK == 0xFF)
+        LATD = bamMask[bamFront][bamBit];
+#else
+        LATD = (LATD & ~BAM_PORT_MASK) | bamMask[bamFront][bamBit];
+#endif
+        PR4 = BamPr[bamBit];
+        T4CON = BamT4con[bamBit];
+
+        bamBit = (bamBit + 1) & 0x07;
+        if ((bamBit == 0) && bamPending)
+        {
+            /* new duties from the next frame on */
+            bamFront = !bamFront;
+            bamPending = 0;
+        }
+    }
+} /* void BamIsr(void) */
@@ -0,0 +1,48 @@
+/*
+ * File:   bam.h
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 3:10 PM
+ */
+
+#ifndef BAM_H
+#define	BAM_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/*
+ * Bit Angle Modulation on PORTD
+ *
+ * each channel is one pin of PORTD (channel 0 = RD0 ... channel 7 = RD7)
+ * a frame is split in 8 periods, period b lasts BAM_UNIT * 2^b and shows
+ * bit b of every duty at once:
+ *
+ *   bit  0 1  2    3        4 ...         7
+ *       |.|..|....|........|....   ...   |
+ *
+ * BamSetDuty() precomputes one port mask per bit, the TMR4 interrupt only
+ * writes the next mask to LATD and loads the next period, so the ISR time
+ * does not depend on the number of channels or on the duties
+ *
+ * TMR4: (10MHz/4) / presc 1:4 => 1.6us/count
+ *   BAM_UNIT = 24 counts = 38.4us (bit 0, longer than the ISR latency)
+ *   frame    = 255 * 38.4us = 9.8ms => 102Hz
+ */
+
+#define BAM_PORT_MASK   (0b00111000)    /* PORTD pins owned by BAM, others are not touched */
+
+
+void BamInit(void);
+void BamSetDuty(unsigned char ch, unsigned char duty);
+void BamIsr(void);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* BAM_H */
+
@@ -13,6 +13,23 @@
 #include "clima.h"
 #include "lcd.h"
 #include "uart.h"
+#include "prof.h"
+#include "pwm.h"
+#include "bam.h"
+#include "pid.h"
+#include "fsm.h"
+#include "debounce.h"
+#include "extint.h"
+#include "fmt.h"
+#include "gesture.h"
+#include "screen.h"
+#include "spibus.h"
+#include "mcp23s17.h"
+#include "eelog.h"
+#include "settings.h"
+#ifdef CLIMA_SIM
+#include "sim/thermal.h"
+#endif
 
 // configuration bits
 #pragma config OSC = HS         // Oscillator Selection bits (HS oscillator)
@@ -25,19 +42,31 @@
 #define DBG_MSG 0
 #if (DBG_MSG == 1)
 #define DBG(x)  UART_puts((char *)x)    // debug messages on UART
+#define DBG_NUM(n)  do { FmtInt(msg, n, 0, ' '); UART_puts(msg); } while (0)
 #else
 #define DBG(x)                  // debug messages are lost
+#define DBG_NUM(n)              // nothing is formatted
 #endif
 
 //                           0123456789012345
 #define LCD_STATE_OFF_1     "  Clima is OFF  "
 #define LCD_STATE_OFF_2     "----------------"
-#define LCD_STATE_ON_COOL_1 "Te:+  C Ti:+  C "
-#define LCD_STATE_ON_COOL_2 "Rece       <  C>"
-#define LCD_STATE_ON_HEAT_1 "Te:+  C Ti:+  C "
-#define LCD_STATE_ON_HEAT_2 "Cald       <  C>"
-#define LCD_STATE_ON_VENT_1 "Te:+  C Ti:+  C "
-#define LCD_STATE_ON_VENT_2 "Vent          C "
+#define LCD_STATE_ON_1      "Te:  " LCD_STR_DEGREE "C Ti:  " LCD_STR_DEGREE "C "
+#define LCD_STATE_ON_COOL_1 LCD_STATE_ON_1
+#define LCD_STATE_ON_COOL_2 "Rece         " LCD_STR_DEGREE "C "
+#define LCD_STATE_ON_HEAT_1 LCD_STATE_ON_1
+#define LCD_STATE_ON_HEAT_2 "Cald         " LCD_STR_DEGREE "C "
+#define LCD_STATE_ON_VENT_1 LCD_STATE_ON_1
+#define LCD_STATE_ON_VENT_2 "Vent         " LCD_STR_DEGREE "C "
+//                           Te:23oC Ti:25oC
+//                           Rece ## v23oC^     fan bar, set temp limits
+
+#define LCD_FAN_CELLS       2   /* fan bar width, 10 columns */
+
+/* LCD pages, rotated by screen.c, a mode change goes back to the clima page */
+#define PAGE_CLIMA          0   /* LcdLines[] of the state */
+#define PAGE_STATUS         1   /* uptime, temperatures, levels, errors */
+#define PAGE_MAX            2
 
 
 
@@ -53,7 +82,6 @@ typedef unsigned char byte;
 #define ON          1
 #define OFF         0
 #define TEMP_STEP   1
-#define FAN_STEPS   6
 #define TEMP_MIN    21
 
 #define TIMER_CYCLE         (100)   // timer cyclic events  (ms)
@@ -64,10 +92,58 @@ typedef unsigned char byte;
 #define TEMP_SENS_LM_OFFSET     (0)     // output voltage @ 0*C
 #define TEMP_SENS_MPC_RES       (19)    // output voltage / *C
 #define TEMP_SENS_LM_RES        (10)    // output voltage / *C
+#define TEMP_SENS_MAX           (99)    // *C, more is an open/shorted sensor
+#define TEMP_SENS_MAX_Q         Q8_8_INT(TEMP_SENS_MAX) // same in Q8.8, fits the 16 bit q8_8
+
+/* errors, bits of climaErrors */
+#define ERR_SENS_OUT            0x01    // outside temperature sensor
+#define ERR_SENS_IN             0x02    // inside temperature sensor
 
+/* temperature PID, runs on each new inside temperature (INPUT_DEBOUNCE_TIME)
+ * output: -255..255, > 0 heat demand, < 0 cool demand (8 bit actuator range)
+ */
+#define PID_KP                  Q8_8(64.0)  // demand per *C of error
+#define PID_KI                  Q8_8(4.0)   // demand per *C of error, each 3s
+#define PID_KD                  Q8_8(96.0)  // demand per *C of change in 3s
+#define PID_OUT_MAX             (255)
+#define FAN_DEMAND_MIN          (128)       // FAN demand in COOL/HEAT (old speed 1)
+
+/* mode changes COOL/HEAT/VENT
+ * VENT -> HEAT/COOL at Tset -/+ DEADBAND, HEAT/COOL -> VENT at Tset +/- DEADBAND
+ * HEAT <-> COOL directly at Tset +/- 2*DEADBAND
+ * no change before STATE_MIN_TIME in the current mode (ON/OFF button excepted)
+ */
+#define TEMP_DEADBAND           Q8_8(1.0)   // *C
+#define STATE_MIN_TIME          (30000)     // time (ms)
+#define STATE_MIN_CNT           (STATE_MIN_TIME/TIMER_CYCLE)
+
+/* cool element = compressor, protected against short cycling */
+#define COOL_MIN_ON_TIME        (60000)     // time (ms)
+#define COOL_MIN_OFF_TIME       (120000)    // time (ms)
+#define COOL_MIN_ON_CNT         (COOL_MIN_ON_TIME/TIMER_CYCLE)
+#define COOL_MIN_OFF_CNT        (COOL_MIN_OFF_TIME/TIMER_CYCLE)
+
+/* state machine events, one per cycle, see climaEvent() */
+typedef enum
+{
+    EV_NONE = 0,
+    EV_BUTTON,              /* ON/OFF button pressed */
+    EV_COLD,                /* Tin < Tset - DEADBAND */
+    EV_VERY_COLD,           /* Tin < Tset - 2*DEADBAND */
+    EV_HOT,                 /* Tin > Tset + DEADBAND */
+    EV_VERY_HOT,            /* Tin > Tset + 2*DEADBAND */
+    EV_MAX
+} event_e;
 
 
 
+
+/* PWM outputs for FANs and heat element
+ * 1 - CCP modules, 10 bit duty, 20kHz FAN carrier (see pwm.h)
+ * 0 - BAM on PORTD (RD3..RD5), 8 bit duty, 102Hz (see bam.h)
+ */
+#define USE_HW_PWM  1
+
 #define TRIS_OUT                0
 #define TRIS_HEAT_ELEMENT       (TRISDbits.TRISD3)
 #define TRIS_HEAT_VENT_FAN      (TRISDbits.TRISD4)
@@ -79,54 +155,158 @@ typedef unsigned char byte;
 #define PIN_FAN_HEAT_VENT       (PORTDbits.RD5)
 #define PIN_HEAT_ELEMENT        (PORTDbits.RD3)
 
+/* BAM channels = PORTD pin number */
+#define BAM_CH_HEAT_ELEMENT     3
+#define BAM_CH_FAN_COOL         4
+#define BAM_CH_FAN_HEAT_VENT    5
+
+/* push buttons on PORTB, active low, one bit per button in the masks
+ * 1 - INT0 edge interrupt, time stamped, EXT_LOCKOUT_TIME against bounces
+ *     (see extint.h), the press reaches the gestures in the same interrupt
+ * 0 - polled in the 4ms ISR slot, DEB_SAMPLES * 4ms = 16ms (see debounce.h)
+ */
+#define USE_EXT_INT             1
+
+#define BTN_PORTB_MASK          (BTN_LEFT)
+#define BTN_LEFT                (1<<0)      // RB0, INT0
+
+#if USE_EXT_INT
+#define BTN_LEVEL(mask)         ExtIntLevel(mask)
+#else
+#define BTN_LEVEL(mask)         DebState(&buttonsB, mask)
+#endif
+
+/* push buttons on the MCP23S17 GPA pins, interrupt on RB2/INT2 (mcp23s17.h)
+ * no SPI while they are idle
+ *  UP / DOWN       set temperature from the buttons, +1*C / -1*C
+ *  UP + DOWN       set temperature from the potentiometer again
+ */
+#define USE_MCP_BUTTONS         1
+
+#define BTN_MCP_MASK            (BTN_UP | BTN_DOWN)
+#define BTN_UP                  (1<<0)      // GPA0, +1*C
+#define BTN_DOWN                (1<<1)      // GPA1, -1*C
+
+/* left button gestures
+ *  click           ON/OFF, at the release
+ *  long press      set temperature from the button, +1*C (36 -> 21)
+ *  hold            +1*C each BTN_REPEAT_TIME
+ *  double click    set temperature from the potentiometer again, only
+ *                  without the expander buttons: a click then waits
+ *                  BTN_DOUBLE_TIME for a second press
+ */
+#if USE_MCP_BUTTONS
+#define BTN_DOUBLE_TIME         (0)         // no double click, ON/OFF not delayed
+#else
+#define BTN_DOUBLE_TIME         (300)       // time (ms)
+#endif
+#define BTN_LONG_TIME           (800)       // time (ms)
+#define BTN_REPEAT_TIME         (400)       // time (ms)
+
+extern mcp_t lcdMcp;                        // the expander of the LCD (lcd.c)
+
+/* history in the 25LC256 (eelog.h), one record each LOG_TIME, 'l' on UART
+ * sends it
+ *   0,1 minutes since power on   2 seconds   3 state   4 set temperature
+ *   5 inside, 6 outside temperature (*C, 0xFF - sensor error)   7 errors
+ */
+#define USE_LOG                 1
+#define LOG_TIME                (10)        // time (s)
+
+/* set temperature and ON/OFF kept over power off (settings.h), bytes of
+ * the settings
+ */
+#define USE_SETTINGS            1
+
+#define SET_TEMP                0           // set temperature (*C)
+#define SET_MANUAL              1           // setTempManual
+#define SET_ON                  2           // 1 - clima was ON
+
 
 void setSpeedFanCool(byte speed);
 void setSpeedFanHeatVent(byte speed);
 void setLevelHeat(byte level);
+void setDemandFanCool(byte demand);
+void setDemandFanHeatVent(byte demand);
+void setDemandHeat(byte demand);
+byte levelToDemand(byte level);
+byte demandToLevel(byte demand);
 
 unsigned int ADCRead(unsigned char ch);
+void checkButtons(void);
 void checkInputs(void);
 byte getOnOffButton(void);
 void test(void);
-void setLcd(void);
-void updateLcd(void);
+void coolProtect(void);
+void drawClima(char *line1, char *line2);
+void drawStatus(char *line1, char *line2);
 void checkInputs(void);
 void stateMachine(void);
+void checkCommands(void);
 void initButtons(void);
 void initAdc(void);
 void initPwm(void);
 void init(void);
+void climaCycle(void);
+void climaButton(void);
+void climaScreen(void);
+void checkMcpButtons(void);
+void climaLog(void);
+void climaSettings(unsigned char *set);
+void climaRestore(void);
 void main(void);
 
 /*******************************************************************************
  * Clima state
  */
-state_e climaState;         /* state of the clima: OFF, VENT, COOL, HEAT */
+extern fsm_t climaFsm;      /* state of the clima: OFF, VENT, COOL, HEAT */
+#define climaState          ((state_e)climaFsm.state)
 
 byte fanSpeedCool;          /* speed for cool fan */
 byte fanSpeedHeatVent;      /* speed for heat/ventilation fan */
 byte levelHeat;             /* heating level */
 
 byte heatElement;           /* LED */
-byte coolElement;           /* LED */
+byte coolElement;           /* LED, compressor output */
+byte coolRequest;           /* state wanted by the state machine */
+unsigned int coolTime = 0;  /* cycles since the last output change, a reset is one */
 byte standbyLed;            /* LED */
 byte lcdBacklightLed;       /* LED */
 
-byte leftButtonEv = 0;      /* event generated when the transition from NOT_PRESSED -> PRESSED is detected on left button */
+deb_t buttonsB;             /* debounced push buttons on PORTB */
+gest_t gestLeft;            /* gestures of the left button */
+const gest_cfg_t gestLeftCfg = { BTN_DOUBLE_TIME, BTN_LONG_TIME, BTN_REPEAT_TIME };
+byte setTempManual = 0;     /* 1 - set temperature from the button, pot ignored */
+byte leftButtonEv = 0;      /* event generated by a click (press + release) of the left button */
 //byte rightButtonEv = 0;
 byte setTemp = 0;           /* desired temperature */
 unsigned int inTemp = 0;            /* interior temperature */
 unsigned int outTemp = 0;   /* outside temperature */
 
 unsigned char tick = 0;
+unsigned int tickMs = 0;    /* ms since reset, time stamps of the gestures */
 unsigned char ev = 0;
 unsigned char cnt = 0;
+unsigned char lcdEv = 0;    /* LCD tick, each SCREEN_TICK_MS */
+unsigned char lcdCnt = 0;
+
+byte upCnt = 0;             /* uptime: cycles of the current second */
+byte upSec = 0;
+byte upMin = 0;
+unsigned int upHour = 0;
+byte climaErrors = 0;       /* ERR_ bits */
+byte logCnt = 0;            /* seconds since the last log record */
 
 
 char msg[20] = {0};         /* used to format print messages */
 
 unsigned char inDeb = 0;    /* debounce counter for temperature sensor */
 
+q8_8 inTempQ = 0;           /* interior temperature, Q8.8 *C */
+byte pidTick = 0;           /* new interior temperature, PID has to run */
+pidc_t pidTemp;             /* interior temperature controller */
+int pidOut = 0;             /* > 0 heat, < 0 cool */
+
 
 
 /*******************************************************************************
@@ -164,11 +344,58 @@ void setHeatElement(unsigned state)
  */
 void setCoolElement(unsigned state)
 {
-    coolElement = state; /* store new state */
+    coolRequest = state; /* store new state, coolProtect() applies it */
+    coolProtect();
 } /* void setCoolElement(unsigned state) */
 
 
 
+/*******************************************************************************
+ * Cool Element Protection Function
+ *  - called each cycle, the compressor stays ON at least COOL_MIN_ON_TIME and
+ *    OFF at least COOL_MIN_OFF_TIME whatever the state machine asks
+ */
+void coolProtect(void)
+{
+    if (coolElement == coolRequest)
+        return;
+
+    if (   (coolElement && (coolTime >= COOL_MIN_ON_CNT))
+        || (!coolElement && (coolTime >= COOL_MIN_OFF_CNT))
+       )
+    {
+        coolElement = coolRequest;
+        coolTime = 0;
+    }
+} /* void coolProtect(void) */
+
+
+
+/*******************************************************************************
+ * Level to Demand Function
+ *  - level in 1/8 steps (0..8, more is 100%) => 8 bit actuator demand
+ */
+byte levelToDemand(byte level)
+{
+    if (level >= 8)
+        return 255;
+
+    return level << 5; /* level * 256/8 */
+} /* byte levelToDemand(byte level) */
+
+
+
+/*******************************************************************************
+ * Demand to Level Function
+ *  - back to 1/8 steps, rounded, for the LCD bars
+ */
+byte demandToLevel(byte demand)
+{
+    return ((unsigned int)demand + 16) >> 5;
+} /* byte demandToLevel(byte demand) */
+
+
+
 /*******************************************************************************
  * Set FAN Speed Function for cool fan
  */
@@ -176,10 +403,26 @@ void setSpeedFanCool(byte speed)
 {
     if (speed)
         speed += 3;
-    fanSpeedCool = speed; /* store new speed */
+    setDemandFanCool(levelToDemand(speed));
 } /* void setSpeedFanCool() */
 
 
+
+/*******************************************************************************
+ * Set FAN Demand Function for cool fan
+ */
+void setDemandFanCool(byte demand)
+{
+    fanSpeedCool = demandToLevel(demand); /* store new speed */
+#if USE_HW_PWM
+    PwmSetFanCoolLevel(demand);
+#else
+    BamSetDuty(BAM_CH_FAN_COOL, PwmFanCurve[demand] >> 2);
+#endif
+} /* void setDemandFanCool(byte demand) */
+
+
+
 /*******************************************************************************
  * Set FAN Speed Function for heat/vent fan
  */
@@ -187,10 +430,26 @@ void setSpeedFanHeatVent(byte speed)
 {
     if (speed)
         speed += 3;
-    fanSpeedHeatVent = speed; /* store new speed */
+    setDemandFanHeatVent(levelToDemand(speed));
 } /* void setSpeedFanHeatVent() */
 
 
+
+/*******************************************************************************
+ * Set FAN Demand Function for heat/vent fan
+ */
+void setDemandFanHeatVent(byte demand)
+{
+    fanSpeedHeatVent = demandToLevel(demand); /* store new speed */
+#if USE_HW_PWM
+    PwmSetFanHeatVentLevel(demand);
+#else
+    BamSetDuty(BAM_CH_FAN_HEAT_VENT, PwmFanCurve[demand] >> 2);
+#endif
+} /* void setDemandFanHeatVent(byte demand) */
+
+
+
 /*******************************************************************************
  * Set Heat level Function
  */
@@ -198,11 +457,27 @@ void setLevelHeat(byte level)
 {
     if (level)
         level += 3;
-    levelHeat = level; /* store new level */
+    setDemandHeat(levelToDemand(level));
 } /* void setLevelHeat() */
 
 
 
+/*******************************************************************************
+ * Set Heat Demand Function
+ *  - resistive load, power is linear in duty, no curve
+ */
+void setDemandHeat(byte demand)
+{
+    levelHeat = demandToLevel(demand); /* store new level */
+#if USE_HW_PWM
+    PwmSetHeat(((unsigned int)demand << 2) | (demand >> 6)); /* 8 => 10 bit */
+#else
+    BamSetDuty(BAM_CH_HEAT_ELEMENT, demand);
+#endif
+} /* void setDemandHeat(byte demand) */
+
+
+
 /*******************************************************************************
  * Check Inputs Function
  */
@@ -220,120 +495,264 @@ byte getOnOffButton(void)
 
 
 /*******************************************************************************
- * Check Inputs Function
+ * Line Put Function
+ *  - text into a line, without its '\0'
  */
-void setLcd(void)
+void linePut(char *dst, const char *src)
 {
-    LcdClear();
-    LcdGoTo(0); /* first Line */
-    LcdWriteString(LcdLines[climaState][0]);
-    LcdGoTo(0x40); /* second Line */
-    LcdWriteString(LcdLines[climaState][1]);
-} /* void setLcd() */
+    while (*src)
+        *dst++ = *src++;
+} /* void linePut(char *dst, const char *src) */
 
 
 
 /*******************************************************************************
- * Check Inputs Function
+ * Temperature Text Function
+ *  - "23", "--" if the sensor has an error
+ */
+char *tempText(char *dst, unsigned int temp, byte err)
+{
+    if (climaErrors & err)
+        return FmtStr(dst, "--");
+
+    return FmtUint(dst, temp, 2, '0');
+} /* char *tempText(char *dst, unsigned int temp, byte err) */
+
+
+
+/*******************************************************************************
+ * Clima Page Function
+ *  - LcdLines[] of the state with the values
  */
-void updateLcd(void)
+void drawClima(char *line1, char *line2)
 {
-    //TODO state_e climaState_old;
     byte fanSpeed = 0;
 
- /* display set temperature */
-    if (climaState != STATE_OFF)
-    {
-        /* out temp */
-        sprintf(msg, "%02d", outTemp);
-
-        LcdGoTo(0x00+4);
-        LcdWriteString(msg);
-
-        /* in temp */
-        sprintf(msg, "%02d", inTemp);
-        LcdGoTo(0x00+12);
-        LcdWriteString(msg);
-
-   /* mode */
-        LcdGoTo(0x40);
-        if (climaState == STATE_ON_COOL)
-            LcdWriteString("Rece");
-        else if (climaState == STATE_ON_HEAT)
-            LcdWriteString("Cald");
-        else if (climaState == STATE_ON_VENT)
-            LcdWriteString("Vent");
-
-    /* fan speed */
-        LcdGoTo(0x40+5);
-        if (climaState == STATE_ON_COOL)
-            fanSpeed = fanSpeedCool;
-        else
-            fanSpeed = fanSpeedHeatVent;
-
-        if (fanSpeed == 4)
-            LcdWriteString("|....");
-        else if (fanSpeed == 5)
-            LcdWriteString("||...");
-        else if (fanSpeed == 6)
-            LcdWriteString("|||..");
-        else if (fanSpeed == 7)
-            LcdWriteString("||||.");
-        else
-            LcdWriteString("|||||");
+    FmtStr(line1, LcdLines[climaState][0]);
+    FmtStr(line2, LcdLines[climaState][1]);
 
-        /* set temp */
-        sprintf(msg, "%d", setTemp);
-        LcdGoTo(0x40+12);
-        LcdWriteString(msg);
+    if (climaState == STATE_OFF)
+        return;
 
-        if (setTemp == TEMP_MIN)
-        {
-            LcdGoTo(0x40+11);
-            LcdWriteString(" ");
-            LcdGoTo(0x40+15);
-            LcdWriteString(">");
-        }
-        else if (setTemp == TEMP_MIN+15)
-        {
-            LcdGoTo(0x40+11); /* second Line */
-            LcdWriteString("<");
-            LcdGoTo(0x40+15); /* second Line */
-            LcdWriteString(" ");
-        }
-        else
-        {
-            LcdGoTo(0x40+11); /* second Line */
-            LcdWriteString("<");
-            LcdGoTo(0x40+15); /* second Line */
-            LcdWriteString(">");
-        }
+    /* out temp */
+    tempText(msg, outTemp, ERR_SENS_OUT);
+    linePut(&line1[3], msg);
+
+    /* in temp */
+    tempText(msg, inTemp, ERR_SENS_IN);
+    linePut(&line1[11], msg);
+
+    /* fan speed, level 0..8 => 0..10 columns */
+    if (climaState == STATE_ON_COOL)
+        fanSpeed = fanSpeedCool;
+    else
+        fanSpeed = fanSpeedHeatVent;
+    LcdBar(msg, (fanSpeed * 5) >> 2, LCD_FAN_CELLS);
+    linePut(&line2[5], msg);
+
+    /* set temp, the arrows show which way it can still move */
+    line2[10] = (setTemp > TEMP_MIN) ? LCD_CH_DOWN : ' ';
+    FmtUint(msg, setTemp, 2, ' ');
+    linePut(&line2[11], msg);
+    line2[15] = (setTemp < TEMP_MIN+15) ? LCD_CH_UP : ' ';
+} /* void drawClima(char *line1, char *line2) */
+
+
+
+/*******************************************************************************
+ * Status Page Function
+ *  - two long lines, they move together with the display shift
+ *    Up 1:02:03  Out 23oC  In 25oC
+ *    Set 24oC  Fan 5/8  Heat 4/8  Ok
+ */
+void drawStatus(char *line1, char *line2)
+{
+    char *p;
+
+    p = FmtStr(line1, "Up ");
+    p = FmtUint(p, upHour, 0, ' ');
+    *p++ = ':';
+    p = FmtUint(p, upMin, 2, '0');
+    *p++ = ':';
+    p = FmtUint(p, upSec, 2, '0');
+    p = FmtStr(p, "  Out ");
+    p = tempText(p, outTemp, ERR_SENS_OUT);
+    p = FmtStr(p, LCD_STR_DEGREE "C  In ");
+    p = tempText(p, inTemp, ERR_SENS_IN);
+    FmtStr(p, LCD_STR_DEGREE "C");
+
+    p = FmtStr(line2, "Set ");
+    p = FmtUint(p, setTemp, 2, ' ');
+    p = FmtStr(p, LCD_STR_DEGREE "C  Fan ");
+    p = FmtUint(p, (climaState == STATE_ON_COOL) ? fanSpeedCool : fanSpeedHeatVent, 0, ' ');
+    p = FmtStr(p, "/8  Heat ");
+    p = FmtUint(p, levelHeat, 0, ' ');
+    p = FmtStr(p, "/8  ");
+    if (climaErrors)
+    {
+        p = FmtStr(p, "Err ");
+        FmtHex(p, climaErrors, 2);
     }
-} /* void updateLcd(state_e state) */
+    else
+        FmtStr(p, "Ok");
+} /* void drawStatus(char *line1, char *line2) */
+
+
+
+const screen_page_t climaPages[PAGE_MAX] =
+{
+    /* draw         time                    flags */
+    {  drawClima,   SCREEN_TICKS(8000),     0            },   /* PAGE_CLIMA */
+    {  drawStatus,  SCREEN_TICKS(12000),    SCREEN_SHIFT },   /* PAGE_STATUS */
+};
 
 
 
 /*******************************************************************************
- * Check Inputs Function
+ * Screen Function
+ *  - each SCREEN_TICK_MS, a few LCD cells
  */
-void checkInputs(void)
+void climaScreen(void)
 {
-    unsigned int adcVal = 0;
-    byte leftButton = 0;
+#if (PROF_EN == 1)
+    if (profLcdPage)
+        return; /* diagnostics page owns the LCD */
+#endif
+    PROF_BEGIN(PROF_LCD);
+    ScreenTick();
+    PROF_END(PROF_LCD);
+} /* void climaScreen(void) */
 
-    static byte leftButton_old = 0;
 
-/* RB0 - check left push button event */
-    leftButton = PORTBbits.RB0;
-    if (   (leftButton == 0) /* push button pressed */
-        && (leftButton != leftButton_old) /* not pressed before */
-       )
+
+/*******************************************************************************
+ * Check Buttons Function
+ *  - RB0 left push button gestures, recognized by the ISR
+ */
+void checkButtons(void)
+{
+    switch (GestGet(&gestLeft))
+    {
+        case GEST_CLICK:
+            leftButtonEv = 1;
+            break;
+        case GEST_LONG:
+        case GEST_REPEAT:
+            setTempManual = 1;
+            setTemp = (setTemp < TEMP_MIN+15) ? setTemp + TEMP_STEP : TEMP_MIN;
+            break;
+        case GEST_DOUBLE:
+            setTempManual = 0;
+            break;
+        default:
+            break;
+    }
+} /* void checkButtons(void) */
+
+
+
+/*******************************************************************************
+ * Check Expander Buttons Function
+ *  - up/down set temperature from the buttons, the pot is ignored until
+ *    both are held together
+ */
+void checkMcpButtons(void)
+{
+    unsigned char pressed = McpInTick(&lcdMcp) & McpInLevel(&lcdMcp, BTN_MCP_MASK);
+
+    if (pressed && (McpInLevel(&lcdMcp, BTN_MCP_MASK) == BTN_MCP_MASK))
+    {
+        setTempManual = 0; /* the second one pressed: back to the pot */
+        return;
+    }
+    if (pressed & BTN_UP)
+    {
+        setTempManual = 1;
+        if (setTemp < TEMP_MIN+15)
+            setTemp += TEMP_STEP;
+    }
+    if (pressed & BTN_DOWN)
     {
-        leftButtonEv = 1;
+        setTempManual = 1;
+        if (setTemp > TEMP_MIN)
+            setTemp -= TEMP_STEP;
     }
-    leftButton_old = leftButton;
+} /* void checkMcpButtons(void) */
+
+
+
+/*******************************************************************************
+ * Log Record Function
+ *  - one LOG_REC_SIZE record of the clima, see USE_LOG
+ */
+void climaLog(void)
+{
+    unsigned char rec[LOG_REC_SIZE];
+    unsigned int minutes = upHour * 60 + upMin;
+
+    rec[0] = minutes & 0xFF;
+    rec[1] = minutes >> 8;
+    rec[2] = upSec;
+    rec[3] = climaState;
+    rec[4] = setTemp;
+    rec[5] = (inTemp > TEMP_SENS_MAX) ? 0xFF : inTemp;
+    rec[6] = (outTemp > TEMP_SENS_MAX) ? 0xFF : outTemp;
+    rec[7] = climaErrors;
+
+    LogAdd(rec);
+} /* void climaLog(void) */
+
 
 
+/*******************************************************************************
+ * Settings Function
+ *  - the settings to keep, from the working variables
+ */
+void climaSettings(unsigned char *set)
+{
+    unsigned char i;
+
+    for (i = 0; i < SETTINGS_SIZE; i++)
+        set[i] = 0;
+    set[SET_TEMP] = setTemp;
+    set[SET_MANUAL] = setTempManual;
+    set[SET_ON] = (climaState != STATE_OFF);
+} /* void climaSettings(unsigned char *set) */
+
+
+
+/*******************************************************************************
+ * Restore Function
+ *  - the settings of the last power on, at the end of init()
+ *  - the pot still sets the temperature unless it was set by the buttons
+ */
+void climaRestore(void)
+{
+    unsigned char set[SETTINGS_SIZE];
+
+    if (!SettingsLoad(set))
+        return; /* never saved, power on values */
+
+    if ((set[SET_TEMP] >= TEMP_MIN) && (set[SET_TEMP] <= TEMP_MIN+15))
+        setTemp = set[SET_TEMP];
+    setTempManual = set[SET_MANUAL] ? 1 : 0;
+
+    if (set[SET_ON])
+        FsmDispatch(&climaFsm, EV_BUTTON); /* ON, as with the button */
+} /* void climaRestore(void) */
+
+
+
+/*******************************************************************************
+ * Check Inputs Function
+ */
+void checkInputs(void)
+{
+    unsigned int adcVal = 0;
+    long tempQ;
+
+    checkButtons();
+
     /* read ADC AN0 - on board potentiometer */
     /* ADC 10 bit resolution
      * AD values     : 0..1023  (1024 values)
@@ -341,15 +760,18 @@ void checkInputs(void)
      * k = 1024/16 = 64
      * setTemp = adcVal/64 + offset
     */
-    adcVal = ADCRead(0);
-    setTemp = adcVal/64 + TEMP_MIN;
+    if (!setTempManual)
+    {
+        adcVal = ADCRead(0);
+        setTemp = adcVal/64 + TEMP_MIN;
+    }
 
     /* debounce temperature measurement: counter elapsed */
     if (inDeb == 0)
     {
         /* read ADC AN1 - on board temperature sensor */
         /* MCP9701:
-         * Resolution: 19mV/*C
+         * Resolution: 19mV per *C
          * OFFSET: U @ 0*C = 400mV
          * T = (U-OFFSET)/resolution
          *
@@ -358,14 +780,17 @@ void checkInputs(void)
          */
         adcVal = ADCRead(1);
         outTemp = (adcVal*5 - TEMP_SENS_MPC_OFFSET)/TEMP_SENS_MPC_RES;
+        if (outTemp > TEMP_SENS_MAX) /* below the offset or open */
+            climaErrors |= ERR_SENS_OUT;
+        else
+            climaErrors &= ~ERR_SENS_OUT;
         DBG("-> Temperature out:");
-        sprintf(msg, "%d", outTemp);
-        DBG(msg);
+        DBG_NUM(outTemp);
         DBG("\n\r");
 
         /* read ADC AN3 - inside temperature sensor */
         /* LM35: 
-         * Resolution: 10mV/*C
+         * Resolution: 10mV per *C
          * Offset: U @ 0*C = 0mV
          * T = (U-OFFSET)/resolution
          *
@@ -374,9 +799,20 @@ void checkInputs(void)
          */
         adcVal = ADCRead(3);
         inTemp = (adcVal*5 - TEMP_SENS_LM_OFFSET)/TEMP_SENS_LM_RES;
+        if (inTemp > TEMP_SENS_MAX)
+            climaErrors |= ERR_SENS_IN;
+        else
+            climaErrors &= ~ERR_SENS_IN;
+        /* same in Q8.8 for the PID: ADC*5/10 *C => ADC*128, keeps the 0.5*C step
+         * computed in long, ADC >= 256 does not fit the 16 bit q8_8: an open or
+         * shorted sensor is clamped to the top of the range, never wraps to cold */
+        tempQ = (long)adcVal << 7;
+        if (tempQ > TEMP_SENS_MAX_Q)
+            tempQ = TEMP_SENS_MAX_Q;
+        inTempQ = (q8_8)tempQ;
+        pidTick = 1;
         DBG("-> Temperature in:");
-        sprintf(msg, "%d", inTemp);
-        DBG(msg);
+        DBG_NUM(inTemp);
         DBG("\n\r");
         
         inDeb = INPUT_DEBOUNCE_CNT;
@@ -391,254 +827,270 @@ void checkInputs(void)
 
 
 /*******************************************************************************
- * State Machine Function
+ * State Machine
+ *  - the modes are data: climaStates[] (entry/exit/do) and climaTrans[][]
+ *    (state x event => next state), fsm.c does the rest
  */
-void stateMachine(void)
+
+/*******************************************************************************
+ * OFF State Actions
+ */
+void offEntry(void)
 {
-    byte err;
+    ScreenShow(PAGE_CLIMA); /* LCD according to OFF state */
+    /* LCD backlight OFF */
+    setLcdBacklightLed(OFF);
+    /* Standby LED ON */
+    setStandbyLed(ON);
+} /* void offEntry(void) */
 
-    DBG("SM:");
-    sprintf(msg, "HS:%d, HL:%d, CS:%d, ", fanSpeedHeatVent, levelHeat, fanSpeedCool);
-    DBG(msg);
-    DBG("\n\r");
+void offExit(void)
+{
+    /* Standby LED OFF */
+    setStandbyLed(OFF);
+    /* LCD backlight ON */
+    setLcdBacklightLed(ON);
 
-    switch (climaState)
-    {
-        case STATE_OFF:
-        {
-            /* ON/OFF button pressed */
-            if (getOnOffButton()) /* transition to ON Ventilation */
-            {
-                DBG("OFF > VENT\n\r");
-                /* STATE = ON Ventilation */
-                climaState = STATE_ON_VENT;
-                /* LCD according to ON state */
-                setLcd();
-
-                /* Standby LED OFF */
-                setStandbyLed(OFF);
-                /* LCD backlight */
-                setLcdBacklightLed(ON);
-                
-                /* heat/vent FAN ON, Speed = 1 */
-                setSpeedFanHeatVent(1);
-            }
-            break;
-        }
-        case STATE_ON_COOL:
-        {
-            /* ON/OFF button pressed */
-            if (getOnOffButton()) /* transition to OFF */
-            {
-                DBG("COOL > OFF\n\r");
-                climaState = STATE_OFF;
-                setLcd(); /* LCD accordingly */
+    /* controller starts from the current temperature */
+    PidReset(&pidTemp, inTempQ);
+    pidOut = 0;
+} /* void offExit(void) */
 
-                /* LCD backlight */
-                setLcdBacklightLed(OFF);
-                /* Standby LED ON */
-                setStandbyLed(ON);
 
-                /* set cool element OFF */
-                setCoolElement(OFF);
 
-                /* cool FAN OFF, Speed = 0 */
-                setSpeedFanCool(0);
-                
-            }
-            else if (inTemp < setTemp) /* have to heat */
-            {
-                DBG("COOL > HEAT\n\r");
-                climaState = STATE_ON_HEAT;
-
-                /* set cool element OFF */
-                setCoolElement(OFF);
-                /* set heat element ON */
-                setHeatElement(ON);
-
-                /* cool FAN OFF, speed = 0 */
-                setSpeedFanCool(0);
-                /* heat/vent FAN ON, speed = 1 */
-                setSpeedFanHeatVent(1);
-                /* heat level 1 */
-                setLevelHeat(1);
-
-                /* LCD accordingly */
-                updateLcd();
-            }
-            else if (inTemp == setTemp) /* have to ventilate */
-            {
-                DBG("COOL > VENT\n\r");
-                climaState = STATE_ON_VENT;
-                setCoolElement(OFF);
+/*******************************************************************************
+ * COOL State Actions
+ */
+void coolEntry(void)
+{
+    /* set cool element ON */
+    setCoolElement(ON);
+    /* cool FAN ON, speed = 1 */
+    setSpeedFanCool(1);
+    /* LCD accordingly */
+    ScreenShow(PAGE_CLIMA);
+} /* void coolEntry(void) */
+
+void coolExit(void)
+{
+    /* set cool element OFF */
+    setCoolElement(OFF);
+    /* cool FAN OFF, speed = 0 */
+    setSpeedFanCool(0);
+} /* void coolExit(void) */
 
-                /* cool FAN OFF, speed = 0 */
-                setSpeedFanCool(0);
-                /* heat/vent FAN ON, speed = 1 */
-                setSpeedFanHeatVent(1);
+void coolDo(void)
+{
+    /* no inside temperature - compressor OFF (coolProtect() keeps its times) */
+    setCoolElement((climaErrors & ERR_SENS_IN) ? OFF : ON);
+    /* update the FAN speed for cool, PID cool demand */
+    if (-pidOut > FAN_DEMAND_MIN)
+        setDemandFanCool(-pidOut);
+    else
+        setDemandFanCool(FAN_DEMAND_MIN);
+} /* void coolDo(void) */
 
-                /* LCD accordingly */
-                updateLcd();
-            }
-            else /* same state, just update */
-            {
-                /* calculate error corection */
-                if ((inTemp - setTemp) <= FAN_STEPS)
-                    err = inTemp - setTemp;
-                else
-                    err = FAN_STEPS;
-
-                /* update the FAN speed for cool */
-                setSpeedFanCool(err);
-            
-                updateLcd();
-            }
-            break;
-        }
-        case STATE_ON_HEAT:
-        {
-            /* ON/OFF button pressed */
-            if (getOnOffButton()) /* transition to OFF */
-            {
-                DBG("HEAT > OFF\n\r");
-                /* STATE = OFF */
-                climaState = STATE_OFF;
-                /* LCD accordingly */
-                setLcd();
-                /* LCD backlight */
-                setLcdBacklightLed(OFF);
-                /* Standby LED ON */
-                setStandbyLed(ON);
-
-                /* set heat element OFF */
-                setHeatElement(OFF);
-
-                /* disable heating */
-                setLevelHeat(0);
-                /* heat/vent FAN OFF, Speed = 0 */
-                setSpeedFanHeatVent(0);
-            }
-            else if (inTemp > setTemp) /* have to cool */
-            {
-                DBG("HEAT > COOL\n\r");
-                /* switch to COOL state */
-                climaState = STATE_ON_COOL;
-
-                /* set cool element ON */
-                setCoolElement(ON);
-                /* set heat element OFF */
-                setHeatElement(OFF);
-
-                /* disable heating */
-                setLevelHeat(0);
-                /* disable heat/vent fan, speed = 0 */
-                setSpeedFanHeatVent(0);
-                /* enable vent fan, speed = 1 */
-                setSpeedFanCool(1);
-
-                /* LCD accordingly */
-                updateLcd();
-            }
-            else if (inTemp == setTemp) /* have to ventilate */
-            {
-                DBG("HEAT > VENT\n\r");
-                /* switch to VENT state */
-                climaState = STATE_ON_VENT;
 
-                /* set heat element OFF */
-                setHeatElement(OFF);
 
-                /* disable heating */
-                setLevelHeat(0);
-                /* set heat/vent fan speed = 1*/
-                setSpeedFanHeatVent(1);
+/*******************************************************************************
+ * HEAT State Actions
+ */
+void heatEntry(void)
+{
+    /* set heat element ON */
+    setHeatElement(ON);
+    /* heat level 1 */
+    setLevelHeat(1);
+    /* heat/vent FAN ON, speed = 1 */
+    setSpeedFanHeatVent(1);
+    /* LCD accordingly */
+    ScreenShow(PAGE_CLIMA);
+} /* void heatEntry(void) */
+
+void heatExit(void)
+{
+    /* set heat element OFF */
+    setHeatElement(OFF);
+    /* disable heating */
+    setLevelHeat(0);
+    /* heat/vent FAN OFF, speed = 0 */
+    setSpeedFanHeatVent(0);
+} /* void heatExit(void) */
 
-                /* LCD accordingly */
-                updateLcd();
-            }
-            else /* same state, just update */
-            {
-                /* calculate error corection */
-                if ((setTemp - inTemp) <= FAN_STEPS)
-                    err = setTemp - inTemp;
-                else
-                    err = FAN_STEPS;
-
-                /* update heat level */
-                setLevelHeat(err);
-                /* update the FAN speed for heat/vent */
-                setSpeedFanHeatVent(err);
-
-                /* LCD accordingly */
-                updateLcd();
-            }
-            break;
-        }
-        case STATE_ON_VENT:
-        {
-            /* ON/OFF button pressed */
-            if (getOnOffButton()) /* transition to ON Ventilation */
-            {
-                DBG("VENT > OFF\n\r");
-                /* STATE = OFF */
-                climaState = STATE_OFF;
+void heatDo(void)
+{
+    /* no inside temperature - heat element OFF, pidOut is 0 */
+    setHeatElement((climaErrors & ERR_SENS_IN) ? OFF : ON);
+    /* update heat level, PID heat demand */
+    if (pidOut > 0)
+        setDemandHeat(pidOut);
+    else
+        setDemandHeat(0);
+    /* update the FAN speed for heat/vent */
+    if (pidOut > FAN_DEMAND_MIN)
+        setDemandFanHeatVent(pidOut);
+    else
+        setDemandFanHeatVent(FAN_DEMAND_MIN);
+} /* void heatDo(void) */
 
-                /* LCD backlight OFF */
-                setLcdBacklightLed(OFF);
 
-                /* Standby LED ON */
-                setStandbyLed(ON);
 
-                /* disable heat/vent fan, Speed = 0 */
-                setSpeedFanHeatVent(0);
+/*******************************************************************************
+ * VENT State Actions
+ */
+void ventEntry(void)
+{
+    /* heat/vent FAN ON, speed = 1 */
+    setSpeedFanHeatVent(1);
+    /* LCD accordingly */
+    ScreenShow(PAGE_CLIMA);
+} /* void ventEntry(void) */
 
-                /* LCD accordingly */
-                setLcd();
-            }
-            else if (inTemp < setTemp) /* have to heat */
-            {
-                DBG("VENT > HEAT\n\r");
-                /* STATE = ON_HEAT */
-                climaState = STATE_ON_HEAT;
+void ventExit(void)
+{
+    /* heat/vent FAN OFF, speed = 0 */
+    setSpeedFanHeatVent(0);
+} /* void ventExit(void) */
 
-                /* set heat element ON */
-                setHeatElement(ON);
 
-                /* activate heat element, level = 1 */
-                setLevelHeat(1);
-                /* activated heat/vent fan, speed = 1 */
-                setSpeedFanHeatVent(1);
 
-                /* LCD accordingly */
-                updateLcd();
-            }
-            else if (inTemp > setTemp) /* have to cool */
-            {
-                DBG("VENT > COOL\n\r");
-                /* STATE = ON_COOL */
-                climaState = STATE_ON_COOL;
-
-                /* set cool element ON */
-                setCoolElement(ON);
-                
-                /* disable heat/vent fan, speed = 0 */
-                setSpeedFanHeatVent(0);
-                /* activate cool fan, speed = 1 */
-                setSpeedFanCool(1);
-
-                updateLcd(); /* LCD accordingly */
-            }
-            else /* same state, just update */
-            {
-                updateLcd();
-            }
-            break;
-        }
-        default:
+/*******************************************************************************
+ * Dwell Guard Function
+ *  - no mode change before STATE_MIN_TIME in the current mode
+ */
+byte dwellOk(void)
+{
+    return (climaFsm.time >= STATE_MIN_CNT);
+} /* byte dwellOk(void) */
+
+
+
+/* same order as state_e */
+const fsm_state_t climaStates[STATE_MAX] =
+{
+    /* entry        exit        do */
+    {  offEntry,    offExit,    0         },    /* STATE_OFF */
+    {  coolEntry,   coolExit,   coolDo    },    /* STATE_ON_COOL */
+    {  heatEntry,   heatExit,   heatDo    },    /* STATE_ON_HEAT */
+    {  ventEntry,   ventExit,   0         },    /* STATE_ON_VENT */
+};
+
+/* state x event => next state, guard, action */
+#define T_NONE                  { FSM_NONE, 0, 0 }
+#define T_NOW(next)             { next, 0, 0 }
+#define T_DWELL(next)           { next, dwellOk, 0 }
+
+const fsm_trans_t climaTrans[STATE_MAX][EV_MAX] =
+{
+    {   /* STATE_OFF */
+        T_NONE,                     /* EV_NONE */
+        T_NOW(STATE_ON_VENT),       /* EV_BUTTON */
+        T_NONE,                     /* EV_COLD */
+        T_NONE,                     /* EV_VERY_COLD */
+        T_NONE,                     /* EV_HOT */
+        T_NONE                      /* EV_VERY_HOT */
+    },
+    {   /* STATE_ON_COOL */
+        T_NONE,
+        T_NOW(STATE_OFF),
+        T_DWELL(STATE_ON_VENT),
+        T_DWELL(STATE_ON_HEAT),
+        T_NONE,
+        T_NONE
+    },
+    {   /* STATE_ON_HEAT */
+        T_NONE,
+        T_NOW(STATE_OFF),
+        T_NONE,
+        T_NONE,
+        T_DWELL(STATE_ON_VENT),
+        T_DWELL(STATE_ON_COOL)
+    },
+    {   /* STATE_ON_VENT */
+        T_NONE,
+        T_NOW(STATE_OFF),
+        T_DWELL(STATE_ON_HEAT),
+        T_DWELL(STATE_ON_HEAT),
+        T_DWELL(STATE_ON_COOL),
+        T_DWELL(STATE_ON_COOL)
+    }
+};
+
+#if (FSM_TRACE == 1)
+const char * const climaStateNames[STATE_MAX] = { "OFF", "COOL", "HEAT", "VENT" };
+#endif
+
+fsm_t climaFsm =
+{
+    climaStates, &climaTrans[0][0], STATE_MAX, EV_MAX, STATE_OFF, 0,
+#if (FSM_TRACE == 1)
+    climaStateNames
+#endif
+};
+
+
+
+/*******************************************************************************
+ * Event Function
+ *  - one event per cycle, the button wins over the temperature
+ */
+event_e climaEvent(void)
+{
+    q8_8 tempSet = Q8_8_INT(setTemp);
+
+    if (getOnOffButton())
+        return EV_BUTTON;
+    if (climaErrors & ERR_SENS_IN)
+        return EV_NONE; /* no temperature, the mode is held */
+    if (inTempQ < tempSet - 2*TEMP_DEADBAND)
+        return EV_VERY_COLD;
+    if (inTempQ < tempSet - TEMP_DEADBAND)
+        return EV_COLD;
+    if (inTempQ > tempSet + 2*TEMP_DEADBAND)
+        return EV_VERY_HOT;
+    if (inTempQ > tempSet + TEMP_DEADBAND)
+        return EV_HOT;
+
+    return EV_NONE;
+} /* event_e climaEvent(void) */
+
+
+
+/*******************************************************************************
+ * State Machine Function
+ */
+void stateMachine(void)
+{
+    DBG("SM:HS:");
+    DBG_NUM(fanSpeedHeatVent);
+    DBG(", HL:");
+    DBG_NUM(levelHeat);
+    DBG(", CS:");
+    DBG_NUM(fanSpeedCool);
+    DBG(", \n\r");
+
+    /* inside sensor error: no demand, the PID starts again from the
+     * temperature that comes back */
+    if (climaErrors & ERR_SENS_IN)
+    {
+        pidTick = 0;
+        pidOut = 0;
+        PidReset(&pidTemp, inTempQ);
+    }
+    /* control tick: new interior temperature */
+    else if (pidTick)
+    {
+        pidTick = 0;
+        if (climaState != STATE_OFF)
         {
-            break;
+            PROF_BEGIN(PROF_PID);
+            pidOut = PidUpdate(&pidTemp, Q8_8_INT(setTemp), inTempQ);
+            PROF_END(PROF_PID);
         }
     }
+
+    FsmDispatch(&climaFsm, climaEvent());
+    FsmRun(&climaFsm);
 } /* void stateMachine(void) */
 
 
@@ -648,6 +1100,11 @@ void stateMachine(void)
  */
 void updateOutputs(void)
 {
+    /* compressor timing */
+    if (coolTime < COOL_MIN_OFF_CNT)
+        coolTime++;
+    coolProtect();
+
     /* put standby LED on the output */
     PORTDbits.RD7 = standbyLed;
 
@@ -663,6 +1120,49 @@ void updateOutputs(void)
 
 
 
+/*******************************************************************************
+ * Check UART Commands Function
+ *  s - print CPU load statistics
+ *  r - reset CPU load statistics
+ *  d - show/hide the diagnostics page on LCD
+ *  l - send the log (eelog.h)
+ */
+void checkCommands(void)
+{
+    char c;
+
+    if (!UART_Data_Ready())
+        return;
+
+    c = UART_Read();
+#if USE_LOG
+    if (c == 'l')
+    {
+        LogDump();
+    }
+#endif
+#if (PROF_EN == 1)
+    if (c == 's')
+    {
+        ProfReport();
+    }
+    else if (c == 'r')
+    {
+        ProfReset();
+    }
+#if (PROF_LCD_PAGE == 1)
+    else if (c == 'd')
+    {
+        profLcdPage = !profLcdPage;
+        /* no display shift under the diagnostics page, the clima page after */
+        ScreenShow(PAGE_CLIMA);
+    }
+#endif
+#endif
+} /* void checkCommands(void) */
+
+
+
 /*******************************************************************************
  * Init Buttons Function
  */
@@ -671,6 +1171,12 @@ void initButtons(void)
     /* RB0 left push button */
     TRISB0 = 1; /* only RB0 as input */
 
+#if USE_EXT_INT
+    ExtIntInit(BTN_PORTB_MASK);
+#else
+    DebInit(&buttonsB, ~PORTB & BTN_PORTB_MASK);
+#endif
+    GestInit(&gestLeft, &gestLeftCfg);
 } /* void initButtons(void) */
 
 
@@ -711,6 +1217,10 @@ unsigned int ADCRead(unsigned char ch)
 {
    if(ch>13) return 0;  //Invalid Channel
 
+#ifdef CLIMA_SIM
+   return ThermalAdc(ch);   // host build: cabin model instead of the ADC
+#endif
+
    ADCON0bits.ADON = 1;     // disable AD module
    ADCON0bits.CHS = ch;      // select channel
    ADCON0bits.ADON = 1;     // switch on the adc module
@@ -728,6 +1238,10 @@ unsigned int ADCRead(unsigned char ch)
  */
 void initPwm(void)
 {
+#if USE_HW_PWM
+    /* CCP modules, TMR1 and TMR2 */
+    PwmInit();
+#else
     /* set pin direction */
 
     /* set pin out for heat element */
@@ -737,6 +1251,9 @@ void initPwm(void)
     /* set pin out for cool fan */
     TRIS_COOL_FAN = TRIS_OUT;
 
+    /* BAM engine, TMR4 */
+    BamInit();
+#endif
 } /* void initPwm(void) */
 
 
@@ -784,6 +1301,24 @@ unsigned char a = 0;
 void interrupt ISR(void)
 {
 // TMR0 interrupt
+    PROF_ISR_BEGIN();
+
+#if !USE_HW_PWM
+    /* TMR4 match, next BAM bit period (first, the shortest period is 38.4us) */
+    BamIsr();
+#endif
+
+#if USE_EXT_INT
+    /* INT0 edge of the left button, the gestures see it at once */
+    if (ExtIntIsr(tickMs) & BTN_LEFT)
+        GestUpdate(&gestLeft, BTN_LEVEL(BTN_LEFT), tickMs);
+#endif
+
+#if USE_MCP_BUTTONS
+    /* INT2 from the expander, read by the main loop */
+    McpInIsr(&lcdMcp);
+#endif
+
     if (T0IE && T0IF)
     {
         T0IF  = 0;              // clear interrupt flag
@@ -793,9 +1328,26 @@ void interrupt ISR(void)
 
         T0CONbits.TMR0ON = 1;   // Turn timer back on
         tick++; // each 1ms
+        tickMs++;
 
         if ((tick & 0b11) == 0b11) // each 4ms
         {
+#if USE_EXT_INT
+            ExtIntTick(tickMs);
+#else
+            DebSample(&buttonsB, ~PORTB & BTN_PORTB_MASK);
+#endif
+            /* nothing to do while released and idle */
+            if (BTN_LEVEL(BTN_LEFT) || GestBusy(&gestLeft))
+                GestUpdate(&gestLeft, BTN_LEVEL(BTN_LEFT), tickMs);
+
+            lcdCnt++;
+            if (lcdCnt == SCREEN_TICK_MS/4) // each 5*4ms = 20ms
+            {
+                lcdEv = 1;
+                lcdCnt = 0;
+            }
+
             cnt++;
             
             if (cnt == 25) // each 25*4ms = 100ms
@@ -807,27 +1359,16 @@ void interrupt ISR(void)
         }
 
         PORTJbits.RJ0 = tick&1;
-
-        /* generate SW PWM for cool FAN */
-        if (fanSpeedCool > (tick & 0x07))
-            PIN_FAN_COOL = PIN_ON;
-        else
-            PIN_FAN_COOL = PIN_OFF;
-
-        /* generate SW PWM for heat/vent FAN */
-        if (fanSpeedHeatVent > (tick & 0x07))
-            PIN_FAN_HEAT_VENT = PIN_ON;
-        else
-            PIN_FAN_HEAT_VENT = PIN_OFF;
-
-        /* generated SW PWM for heat element */
-        if (levelHeat  > (tick & 0x07))
-            PIN_HEAT_ELEMENT = PIN_ON;
-        else
-            PIN_HEAT_ELEMENT = PIN_OFF;
     }
 
+#if USE_HW_PWM
+    /* TMR1 overflow, start of the heat element window */
+    PwmIsr();
+#endif
+
     // process other interrupt sources here, if required
+
+    PROF_ISR_END();
 }
 
 
@@ -857,16 +1398,36 @@ void init(void)
     /* init TMR */
     initTmr();
 
-    /* init LCD */
+    /* init SPI bus, then the LCD on its expander */
+    SpiBusInit();
     LcdInit();
+    ScreenInit(climaPages, PAGE_MAX);
+#if USE_MCP_BUTTONS
+    /* expander buttons, after the LCD set up the expander */
+    McpInInit(&lcdMcp, BTN_MCP_MASK);
+#endif
+#if USE_LOG
+    /* log, goes on after the newest page */
+    LogInit();
+#endif
+
+#if (PROF_EN == 1)
+    /* init CPU load measurement */
+    ProfInit();
+#endif
+
+    /* init temperature controller */
+    PidInit(&pidTemp, PID_KP, PID_KI, PID_KD, -PID_OUT_MAX, PID_OUT_MAX);
 
 /* START - transition from "Power OFF" to "OFF"*/
     DBG("-> T to OFF\n\r");
-    climaState = STATE_OFF;
-    setLcd(); /* LCD according to OFF state */
+    /* compressor OFF, COOL_MIN_OFF_TIME before it may start (brown-out while cranking) */
+    coolRequest = OFF;
+    coolElement = OFF;
+    coolTime = 0;
+    PORTDbits.RD1 = OFF;
+    FsmInit(&climaFsm, STATE_OFF); /* LCD, LEDs according to OFF state */
 
-    /* Standby LED ON */
-    setStandbyLed(ON);
     /* set Heating element OFF */
     setHeatElement(OFF);
 
@@ -875,13 +1436,99 @@ void init(void)
     /* heat/vent FAN speed 0 = OFF */
     setSpeedFanHeatVent(0);
     /* Heat level 0 = OFF */
-    setHeatElement(0);
+    setLevelHeat(0);
 
 /* END - transition from "Power OFF" to "OFF"*/
+
+#if USE_SETTINGS
+    /* back to the settings of the last drive */
+    climaRestore();
+#endif
 } /* void init(void) */
 
 
 
+/*******************************************************************************
+ * Main Cycle Function
+ *  - one 100ms cycle, called by main() and by the host simulator (sim/)
+ */
+void climaCycle(void)
+{
+#if USE_SETTINGS
+    unsigned char set[SETTINGS_SIZE];
+#endif
+
+    PROF_BEGIN(PROF_CHECK_INPUTS);
+    checkInputs();
+    PROF_END(PROF_CHECK_INPUTS);
+
+    PROF_BEGIN(PROF_STATE_MACHINE);
+    stateMachine();
+    PROF_END(PROF_STATE_MACHINE);
+
+    PROF_BEGIN(PROF_UPDATE_OUTPUTS);
+    updateOutputs();
+    PROF_END(PROF_UPDATE_OUTPUTS);
+
+    checkCommands();
+#if (PROF_EN == 1)
+    ProfFrame();
+    if (profLcdPage)
+        ProfLcd();
+#endif
+
+    /* uptime */
+    if (++upCnt == 1000/TIMER_CYCLE)
+    {
+        upCnt = 0;
+#if USE_LOG
+        if (++logCnt == LOG_TIME)
+        {
+            logCnt = 0;
+            climaLog();
+        }
+#endif
+#if USE_SETTINGS
+        climaSettings(set);
+        SettingsTick(set);
+#endif
+        if (++upSec == 60)
+        {
+            upSec = 0;
+            if (++upMin == 60)
+            {
+                upMin = 0;
+                upHour++;
+            }
+        }
+    }
+
+    /* clear events */
+    leftButtonEv = 0; /* clear event from left button */
+} /* void climaCycle(void) */
+
+
+
+/*******************************************************************************
+ * Button Function
+ *  - called by main() as soon as a gesture is recognized, between two cycles
+ *  - ON/OFF is dispatched at once, the cycle counters (PID, dwell and
+ *    compressor times) are left to climaCycle()
+ */
+void climaButton(void)
+{
+    checkButtons();
+
+    if (getOnOffButton())
+    {
+        FsmDispatch(&climaFsm, EV_BUTTON);
+        leftButtonEv = 0;
+    }
+} /* void climaButton(void) */
+
+
+
+#ifndef CLIMA_SIM
 /*******************************************************************************
  * Main Function
  */
@@ -902,24 +1549,46 @@ void main(void)
 /* START - endless loop */
     while(1)
     {
-        while (ev == 0);
+        /* wait the 100ms timer event, the LCD tick or a button gesture,
+         * the queued SPI frames go out meanwhile */
+        while ((ev == 0) && (lcdEv == 0) && (gestLeft.event == GEST_NONE))
+        {
+            SpiBusTask();
+#if USE_LOG
+            LogTask();
+#endif
+#if USE_SETTINGS
+            SettingsTask();
+#endif
+        }
+
+        if (lcdEv)
+        {
+            lcdEv = 0;
+#if USE_MCP_BUTTONS
+            checkMcpButtons();
+#endif
+            climaScreen();
+        }
+
+        if (ev == 0)
+        {
+            climaButton();
+            continue;
+        }
         ev = 0;
 
         i++;
         PORTJbits.RJ2 = 1;
 
-        checkInputs();
-        stateMachine();
-        updateOutputs();
-
-        /* clear events */
-        leftButtonEv = 0; /* clear event from left button */
+        climaCycle();
 
         PORTJbits.RJ2 = 0;
     }
 /* END - endless loop */
 
 } /* void main(void) */
+#endif /* CLIMA_SIM */
 
 
 
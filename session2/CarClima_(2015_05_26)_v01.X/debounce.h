@@ -0,0 +1,59 @@
+/*
+ * File:   debounce.h
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 7:10 PM
+ */
+
+#ifndef DEBOUNCE_H
+#define	DEBOUNCE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/* bit parallel debouncer, 8 inputs of one port at once (vertical counters)
+ *
+ * every input has a 2 bit counter, bit 0 of all the counters is cnt0 and
+ * bit 1 is cnt1, so the 8 counters are updated with a few byte operations
+ * whatever the number of buttons:
+ *
+ *     changed = state ^ raw        inputs different from the debounced state
+ *     counter reset to 3 where the input equals the state, else counter - 1
+ *     an input toggles its state when its counter wraps (DEB_SAMPLES equal
+ *     samples in a row)
+ *
+ * DebSample() is called by the timer ISR with the raw port, 1 = pressed
+ * (invert the port for active low buttons), the edges are latched until
+ * the main loop reads them
+ */
+
+#define DEB_SAMPLES     4       /* equal samples to accept a change, 2 bit counters */
+
+
+typedef struct
+{
+    unsigned char state;    /* debounced inputs, 1 = pressed */
+    unsigned char cnt0;     /* vertical counter, bit 0 */
+    unsigned char cnt1;     /* vertical counter, bit 1 */
+    unsigned char press;    /* latched 0 -> 1 edges */
+    unsigned char release;  /* latched 1 -> 0 edges */
+} deb_t;
+
+
+/* debounced level of the inputs in mask, no edge is cleared */
+#define DebState(d, mask)   ((d)->state & (mask))
+
+void DebInit(deb_t *d, unsigned char raw);
+void DebSample(deb_t *d, unsigned char raw);
+unsigned char DebPressed(deb_t *d, unsigned char mask);
+unsigned char DebReleased(deb_t *d, unsigned char mask);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* DEBOUNCE_H */
+
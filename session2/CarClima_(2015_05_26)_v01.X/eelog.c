@@ -0,0 +1,314 @@
+/*
+ * File:   eelog.c
+ * Author: Dragos
+ *
+ * Created on October 20, 2026, 1:40 AM
+ */
+
+#include "eelog.h"
+#include "spibus.h"
+#include "uart.h"
+#include "fmt.h"
+
+
+/* 25LC256 instructions */
+#define EE_READ         0x03
+#define EE_WRITE        0x02
+#define EE_WREN         0x06
+#define EE_RDSR         0x05
+#define EE_SR_WIP       0x01    /* write in progress */
+
+/* states of LogTask() */
+#define LOG_IDLE        0
+#define LOG_WRITE       1       /* page sent, RDSR polled */
+#define LOG_READ        2       /* page of the dump read */
+
+
+unsigned char logPage[2][LOG_PAGE_SIZE];    /* one filled, one written */
+unsigned char logFill = 0;      /* buffer of LogAdd() */
+unsigned char logRecs = 0;      /* records in it */
+unsigned int logHead = 0;       /* next page to write */
+unsigned int logUsed = 0;       /* written pages, LOG_PAGES at most */
+unsigned int logSeq = 0;        /* sequence of the next page */
+unsigned char logBoot = 0;      /* power cycle, in the page headers */
+unsigned int logLost = 0;       /* records dropped: full buffers, failed writes */
+
+unsigned char logState = LOG_IDLE;
+unsigned char logTicket;        /* last transaction queued, see SpiDone() */
+unsigned char logStatus;        /* RDSR answer */
+unsigned int logPolls;          /* RDSR reads of the write */
+
+unsigned char logDumping = 0;   /* LogDump() running */
+unsigned int logDumpLeft;       /* pages still to read */
+unsigned int logDumpPage;       /* next page to read */
+unsigned char logDumpPos;       /* next byte to send, LOG_PAGE_SIZE - none */
+unsigned char logDumpBuf[LOG_PAGE_SIZE];
+
+char logMsg[24];
+
+
+
+/*******************************************************************************
+ * Queue Function
+ *  - one instruction with the 16 bit address of page
+ */
+unsigned char logQueue(unsigned char instr, unsigned int page,
+                       const unsigned char *tx, unsigned char *rx, unsigned char len)
+{
+    unsigned char hdr[3];
+    unsigned int addr = page * LOG_PAGE_SIZE;
+
+    hdr[0] = instr;
+    hdr[1] = addr >> 8;
+    hdr[2] = addr & 0xFF;
+
+    return SpiQueue(SPI_DEV_EEPROM, hdr, 3, tx, rx, len);
+} /* unsigned char logQueue(...) */
+
+
+
+/*******************************************************************************
+ * Header Function
+ *  - 1 if page is written, its sequence in seq and its boot in boot
+ */
+unsigned char logHeader(unsigned int page, unsigned int *seq, unsigned char *boot)
+{
+    unsigned char h[4];
+
+    logQueue(EE_READ, page, 0, h, 4);
+    SpiSync(SPI_DEV_EEPROM);
+
+    *boot = h[1];
+    *seq = h[2] | ((unsigned int)h[3] << 8);
+
+    return (h[0] == LOG_MAGIC);
+} /* unsigned char logHeader(...) */
+
+
+
+/*******************************************************************************
+ * Poll Function
+ *  - RDSR until WIP is 0, the page is then the newest
+ */
+void logPoll(void)
+{
+    unsigned char rdsr = EE_RDSR;
+
+    if (!SpiDone(SPI_DEV_EEPROM, logTicket))
+        return;
+
+    if ((logStatus & EE_SR_WIP) == 0)
+    {
+        if (++logHead == LOG_PAGES)
+            logHead = 0;
+        if (logUsed < LOG_PAGES)
+            logUsed++;
+        logSeq++;
+        logState = LOG_IDLE;
+        return;
+    }
+
+    if (++logPolls == LOG_POLL_MAX)
+    {
+        /* no EEPROM or it hangs, the same page is tried with the next records */
+        logLost += LOG_PAGE_RECS;
+        logState = LOG_IDLE;
+        return;
+    }
+
+    logTicket = SpiQueue(SPI_DEV_EEPROM, &rdsr, 1, 0, &logStatus, 1);
+} /* void logPoll(void) */
+
+
+
+/*******************************************************************************
+ * Write Function
+ *  - the full buffer to the head page, the other one takes the records
+ */
+void logWrite(void)
+{
+    unsigned char *pg = logPage[logFill];
+    unsigned char instr = EE_WREN;
+    unsigned char i;
+
+    pg[0] = LOG_MAGIC;
+    pg[1] = logBoot;
+    pg[2] = logSeq & 0xFF;
+    pg[3] = logSeq >> 8;
+    for (i = 4; i < LOG_HDR_SIZE; i++)
+        pg[i] = 0xFF;
+
+    logFill ^= 1;
+    logRecs = 0;
+
+    SpiQueue(SPI_DEV_EEPROM, &instr, 1, 0, 0, 0);   /* WEL is cleared by each write */
+    logQueue(EE_WRITE, logHead, pg, 0, LOG_PAGE_SIZE);
+    instr = EE_RDSR;
+    logTicket = SpiQueue(SPI_DEV_EEPROM, &instr, 1, 0, &logStatus, 1);
+
+    logPolls = 0;
+    logState = LOG_WRITE;
+} /* void logWrite(void) */
+
+
+
+/*******************************************************************************
+ * Dump Step Function
+ *  - the bytes the transmitter takes now, the next page when all are sent
+ */
+void logDumpStep(void)
+{
+    if (logDumpPos < LOG_PAGE_SIZE)
+    {
+        while ((logDumpPos < LOG_PAGE_SIZE) && UART_Tx_Ready())
+            UART_Send(logDumpBuf[logDumpPos++]);
+        return;
+    }
+
+    if (logDumpLeft == 0)
+    {
+        logDumping = 0;
+        return;
+    }
+
+    logDumpLeft--;
+    logTicket = logQueue(EE_READ, logDumpPage, 0, logDumpBuf, LOG_PAGE_SIZE);
+    if (++logDumpPage == LOG_PAGES)
+        logDumpPage = 0;
+    logState = LOG_READ;
+} /* void logDumpStep(void) */
+
+
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONs                                                        BEGIN
+ */
+
+
+/*******************************************************************************
+ * Init Function
+ *  - after SpiBusInit(), finds the newest page from the headers
+ *  - reads all the headers of a full log, about 0.2s with the SW SPI
+ */
+void LogInit(void)
+{
+    unsigned int page;
+    unsigned int seq;
+    unsigned int prev;
+    unsigned char boot;
+    unsigned char next;
+    unsigned char blank = 0;
+
+    logFill = 0;
+    logRecs = 0;
+    logHead = 0;
+    logUsed = 0;
+    logSeq = 0;
+    logBoot = 0;
+    logState = LOG_IDLE;
+    logDumping = 0;
+
+    if (!logHeader(0, &prev, &boot))
+        return; /* blank EEPROM */
+
+    for (page = 1; page < LOG_PAGES; page++)
+    {
+        if (!logHeader(page, &seq, &next))
+        {
+            blank = 1;
+            break;
+        }
+        if (seq != prev + 1)
+            break; /* an older page, the ring wrapped */
+        prev = seq;
+        boot = next;
+    }
+
+    /* page: the oldest one, or the first blank one before the ring wrapped */
+    logHead = (page == LOG_PAGES) ? 0 : page;
+    logUsed = blank ? page : LOG_PAGES;
+    logSeq = prev + 1;
+    logBoot = boot + 1;
+} /* void LogInit(void) */
+
+
+/*******************************************************************************
+ * Add Function
+ *  - one record of LOG_REC_SIZE bytes, copied
+ */
+void LogAdd(const unsigned char *rec)
+{
+    unsigned char *dst;
+    unsigned char i;
+
+    if (logRecs == LOG_PAGE_RECS)
+    {
+        logLost++; /* the other page is still being written */
+        return;
+    }
+
+    dst = &logPage[logFill][LOG_HDR_SIZE + logRecs * LOG_REC_SIZE];
+    for (i = 0; i < LOG_REC_SIZE; i++)
+        dst[i] = rec[i];
+    logRecs++;
+} /* void LogAdd(const unsigned char *rec) */
+
+
+/*******************************************************************************
+ * Task Function
+ *  - call it from the main loop as often as possible, it never waits
+ */
+void LogTask(void)
+{
+    switch (logState)
+    {
+    case LOG_WRITE:
+        logPoll();
+        break;
+
+    case LOG_READ:
+        if (SpiDone(SPI_DEV_EEPROM, logTicket))
+        {
+            logDumpPos = 0;
+            logState = LOG_IDLE;
+        }
+        break;
+
+    default:
+        if (logDumping)
+            logDumpStep();
+        else if (logRecs == LOG_PAGE_RECS)
+            logWrite();
+        break;
+    }
+} /* void LogTask(void) */
+
+
+/*******************************************************************************
+ * Dump Function
+ *  - a text line with the number of pages, then the pages, binary, oldest
+ *    first; LogTask() sends them
+ */
+void LogDump(void)
+{
+    char *p;
+
+    if (logDumping)
+        return;
+
+    p = FmtStr(logMsg, "\n\rlog ");
+    p = FmtUint(p, logUsed, 0, ' ');
+    p = FmtStr(p, " pages\n\r");
+    UART_puts(logMsg);
+
+    logDumpLeft = logUsed;
+    logDumpPage = (logHead >= logUsed) ? logHead - logUsed : logHead + LOG_PAGES - logUsed;
+    logDumpPos = LOG_PAGE_SIZE;
+    logDumping = 1;
+} /* void LogDump(void) */
+
+
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONs                                                          END
+ */
@@ -0,0 +1,59 @@
+/*
+ * File:   eelog.h
+ * Author: Dragos
+ *
+ * Created on October 20, 2026, 1:40 AM
+ */
+
+#ifndef EELOG_H
+#define	EELOG_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/* history log in the 25LC256 SPI EEPROM of the explorer board (32KB, 512
+ * pages of 64 bytes, SPI_DEV_EEPROM in spibus.h)
+ *
+ * records of LOG_REC_SIZE bytes are gathered in RAM, a full page is written
+ * with one WRITE (one write cycle for 7 records); two page buffers, the
+ * records go on while the other page is written
+ *
+ *   page   0       header: LOG_MAGIC, boot, sequence (16 bit, little end.)
+ *          8..63   7 records, the content is the caller's
+ *
+ * the pages are used in a ring, the sequence goes up by one each page; at
+ * boot LogInit() reads the headers and goes on after the last page, where
+ * the sequence breaks; boot counts the power cycles, the time in the
+ * records starts again with each of them
+ *
+ * the end of a write is polled with RDSR (WIP), not waited 5ms
+ *
+ * LogDump() sends all the written pages on UART, the oldest first, at the
+ * full baud rate: LogTask() puts a byte each time the transmitter is free,
+ * nothing waits; no page is written meanwhile
+ */
+
+#define LOG_PAGE_SIZE       64
+#define LOG_PAGES           512     /* 32KB */
+#define LOG_REC_SIZE        8
+#define LOG_HDR_SIZE        LOG_REC_SIZE
+#define LOG_PAGE_RECS       ((LOG_PAGE_SIZE - LOG_HDR_SIZE) / LOG_REC_SIZE)
+#define LOG_MAGIC           0xA7    /* first header byte of a written page */
+
+#define LOG_POLL_MAX        2000    /* RDSR polls before a write is given up */
+
+
+void LogInit(void);
+void LogAdd(const unsigned char *rec);
+void LogTask(void);
+void LogDump(void);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* EELOG_H */
+
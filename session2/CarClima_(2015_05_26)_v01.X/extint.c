@@ -0,0 +1,201 @@
+/*
+ * File:   extint.c
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 8:50 PM
+ */
+
+#include <p18f8722.h>
+
+#include "extint.h"
+
+
+volatile unsigned char extIntLevel = 0;     /* accepted level, 1 = pressed */
+unsigned char extIntMask = 0;               /* pins handled */
+unsigned char extIntLocked = 0;             /* pins inside the lockout window */
+unsigned char extIntPress = 0;              /* latched 0 -> 1 edges */
+unsigned char extIntRelease = 0;            /* latched 1 -> 0 edges */
+unsigned int extIntStamp[8];                /* ms, last accepted edge per pin */
+
+
+
+/*******************************************************************************
+ * External Interrupt Accept Function
+ *  - the pins in mask whose level changed are accepted, stamped and locked
+ *  - returns the accepted pins
+ */
+unsigned char extIntAccept(unsigned char mask, unsigned int now)
+{
+    unsigned char changed;
+    unsigned char pin;
+    unsigned char bit;
+
+    changed = ((~PORTB & extIntMask) ^ extIntLevel) & mask;
+    if (changed == 0)
+        return 0;
+
+    extIntLevel ^= changed;
+    extIntPress |= extIntLevel & changed;
+    extIntRelease |= ~extIntLevel & changed;
+    extIntLocked |= changed;
+
+    for (pin = 0, bit = 1; pin < 8; pin++, bit <<= 1)
+    {
+        if (changed & bit)
+            extIntStamp[pin] = now;
+    }
+
+    /* next edge: rising (release) while pressed, falling (press) while released */
+    INTEDG0 = (extIntLevel & EXT_RB0) ? 1 : 0;
+    INTEDG1 = (extIntLevel & EXT_RB1) ? 1 : 0;
+
+    return changed;
+} /* unsigned char extIntAccept(unsigned char mask, unsigned int now) */
+
+
+
+/*******************************************************************************
+ * External Interrupt Init Function
+ *  - mask: EXT_RB0, EXT_RB1, RB4..RB7, the pins are set as inputs
+ *  - GIE is set later, by the timer init
+ */
+void ExtIntInit(unsigned char mask)
+{
+    TRISB |= mask;
+
+    extIntMask = mask;
+    extIntLevel = ~PORTB & mask;    /* a button held during reset is no press */
+    extIntLocked = 0;
+    extIntPress = 0;
+    extIntRelease = 0;
+
+    INTEDG0 = (extIntLevel & EXT_RB0) ? 1 : 0;
+    INTEDG1 = (extIntLevel & EXT_RB1) ? 1 : 0;
+
+    INT0IF = 0;
+    INT0IE = (mask & EXT_RB0) ? 1 : 0;
+    INT1IF = 0;
+    INT1IE = (mask & EXT_RB1) ? 1 : 0;
+    RBIF = 0;                       /* PORTB was read above, no mismatch */
+    RBIE = (mask & EXT_RB_IOC) ? 1 : 0;
+} /* void ExtIntInit(unsigned char mask) */
+
+
+
+/*******************************************************************************
+ * External Interrupt ISR Function
+ *  - call it from the interrupt service routine, now: ms time stamp
+ *  - returns the pins with a new level
+ */
+unsigned char ExtIntIsr(unsigned int now)
+{
+    unsigned char edge = 0;
+    unsigned char changed = 0;
+
+    if (INT0IE && INT0IF)
+    {
+        INT0IF = 0;
+        edge = 1;
+    }
+    if (INT1IE && INT1IF)
+    {
+        INT1IF = 0;
+        edge = 1;
+    }
+    if (RBIE && RBIF)
+    {
+        edge = 1;
+    }
+
+    if (edge)
+    {
+        /* reads PORTB, ends the RB4..RB7 mismatch before RBIF is cleared */
+        changed = extIntAccept(~extIntLocked, now);
+        RBIF = 0;
+    }
+
+    return changed;
+} /* unsigned char ExtIntIsr(unsigned int now) */
+
+
+
+/*******************************************************************************
+ * External Interrupt Tick Function
+ *  - call it from the timer interrupt, ends the lockout windows
+ *  - returns at once when no pin is locked
+ */
+void ExtIntTick(unsigned int now)
+{
+    unsigned char pin;
+    unsigned char bit;
+    unsigned char done = 0;
+
+    if (extIntLocked == 0)
+        return;
+
+    for (pin = 0, bit = 1; pin < 8; pin++, bit <<= 1)
+    {
+        if ((extIntLocked & bit) && ((unsigned int)(now - extIntStamp[pin]) >= EXT_LOCKOUT_TIME))
+            done |= bit;
+    }
+
+    if (done)
+    {
+        extIntLocked &= ~done;
+        /* an edge ignored inside the window may have changed the level */
+        extIntAccept(done, now);
+    }
+} /* void ExtIntTick(unsigned int now) */
+
+
+
+/*******************************************************************************
+ * External Interrupt Pressed Function
+ *  - returns and clears the press edges in mask
+ */
+unsigned char ExtIntPressed(unsigned char mask)
+{
+    unsigned char edges;
+
+    GIE = 0;
+    edges = extIntPress & mask;
+    extIntPress ^= edges;
+    GIE = 1;
+
+    return edges;
+} /* unsigned char ExtIntPressed(unsigned char mask) */
+
+
+
+/*******************************************************************************
+ * External Interrupt Released Function
+ *  - returns and clears the release edges in mask
+ */
+unsigned char ExtIntReleased(unsigned char mask)
+{
+    unsigned char edges;
+
+    GIE = 0;
+    edges = extIntRelease & mask;
+    extIntRelease ^= edges;
+    GIE = 1;
+
+    return edges;
+} /* unsigned char ExtIntReleased(unsigned char mask) */
+
+
+
+/*******************************************************************************
+ * External Interrupt Stamp Function
+ *  - ms time stamp of the last accepted edge of pin (0..7)
+ */
+unsigned int ExtIntStamp(unsigned char pin)
+{
+    unsigned int stamp;
+
+    GIE = 0;
+    stamp = extIntStamp[pin];
+    GIE = 1;
+
+    return stamp;
+} /* unsigned int ExtIntStamp(unsigned char pin) */
@@ -0,0 +1,55 @@
+/*
+ * File:   extint.h
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 8:50 PM
+ */
+
+#ifndef EXTINT_H
+#define	EXTINT_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/* interrupt driven push buttons on PORTB, active low
+ *
+ *   RB0 - INT0, RB1 - INT1    edge interrupt, the edge is switched after each
+ *                             accepted change to catch press and release
+ *   RB4..RB7                  interrupt on change
+ *
+ * the first edge of a pin is accepted at once and time stamped with the
+ * system tick, then the pin is locked for EXT_LOCKOUT_TIME so the bounces
+ * are ignored; at the end of the lockout ExtIntTick() reads the pin again,
+ * a release hidden in the bounces is not lost
+ *
+ * the masks use the PORTB bit positions, 1 = pressed
+ */
+
+#define EXT_LOCKOUT_TIME    (20)        // time (ms)
+
+#define EXT_RB0             (1<<0)      // INT0
+#define EXT_RB1             (1<<1)      // INT1
+#define EXT_RB_IOC          (0xF0)      // RB4..RB7, interrupt on change
+
+
+extern volatile unsigned char extIntLevel;
+
+/* accepted level of the pins in mask, 1 = pressed */
+#define ExtIntLevel(mask)   (extIntLevel & (mask))
+
+void ExtIntInit(unsigned char mask);
+unsigned char ExtIntIsr(unsigned int now);
+void ExtIntTick(unsigned int now);
+unsigned char ExtIntPressed(unsigned char mask);
+unsigned char ExtIntReleased(unsigned char mask);
+unsigned int ExtIntStamp(unsigned char pin);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* EXTINT_H */
+
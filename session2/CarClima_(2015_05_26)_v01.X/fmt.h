@@ -0,0 +1,47 @@
+/*
+ * File:   fmt.h
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 9:40 PM
+ */
+
+#ifndef FMT_H
+#define	FMT_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/* small number formatter, replaces sprintf() in the LCD and UART paths
+ *
+ *   sprintf(msg, "%02u", t)      =>  FmtUint(msg, t, 2, '0')
+ *   sprintf(msg, "%3d", t)       =>  FmtInt(msg, t, 3, ' ')
+ *   sprintf(msg, "%04X", t)      =>  FmtHex(msg, t, 4)
+ *   sprintf(msg, "%d.%d", t/10, t%10)  =>  FmtFix1(msg, t, 0)
+ *
+ * every function writes at dst, ends the text with '\0' and returns the
+ * position of the '\0', so the calls can be chained on the same buffer:
+ *
+ *     p = FmtUint(msg, ore, 2, '0');
+ *     *p++ = ':';
+ *     p = FmtUint(p, minute, 2, '0');
+ *
+ * the decimal digits come from Bcd16() (bcd.h), no division (___lwdiv,
+ * ___lwmod) and no format string parsing; width is the least number of
+ * characters (5 digits + sign at most), 0 - no padding
+ */
+
+char *FmtUint(char *dst, unsigned int val, unsigned char width, char pad);
+char *FmtInt(char *dst, int val, unsigned char width, char pad);
+char *FmtHex(char *dst, unsigned int val, unsigned char digits);
+char *FmtFix1(char *dst, int val, unsigned char width);
+char *FmtStr(char *dst, const char *s);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* FMT_H */
+
@@ -0,0 +1,108 @@
+/*
+ * File:   fsm.c
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 6:00 PM
+ */
+
+#include "fsm.h"
+#if (FSM_TRACE == 1)
+#include "uart.h"
+#include "fmt.h"
+#endif
+
+
+#if (FSM_TRACE == 1)
+char fsmMsg[32];            /* used to format the trace */
+
+
+
+/*******************************************************************************
+ * FSM Trace Function
+ *  - "FSM: OFF > VENT (1)" = from > to (event)
+ */
+void fsmTrace(fsm_t *fsm, unsigned char next, unsigned char event)
+{
+    char *p = FmtStr(fsmMsg, "FSM: ");
+
+    if (fsm->names)
+    {
+        p = FmtStr(p, fsm->names[fsm->state]);
+        p = FmtStr(p, " > ");
+        p = FmtStr(p, fsm->names[next]);
+    }
+    else
+    {
+        p = FmtUint(p, fsm->state, 0, ' ');
+        p = FmtStr(p, " > ");
+        p = FmtUint(p, next, 0, ' ');
+    }
+    p = FmtStr(p, " (");
+    p = FmtUint(p, event, 0, ' ');
+    FmtStr(p, ")\n\r");
+    UART_puts(fsmMsg);
+} /* void fsmTrace(...) */
+#endif
+
+
+
+/*******************************************************************************
+ * FSM Init Function
+ *  - the tables and sizes are set by the application, the initial state is
+ *    entered (its entry action runs)
+ */
+void FsmInit(fsm_t *fsm, unsigned char state)
+{
+    fsm->state = state;
+    fsm->time = 0;
+    if (fsm->states[state].entry)
+        fsm->states[state].entry();
+} /* void FsmInit(fsm_t *fsm, unsigned char state) */
+
+
+
+/*******************************************************************************
+ * FSM Dispatch Function
+ */
+void FsmDispatch(fsm_t *fsm, unsigned char event)
+{
+    const fsm_trans_t *t;
+
+    if (event >= fsm->nEvents)
+        return;
+
+    t = &fsm->trans[fsm->state * fsm->nEvents + event];
+    if (t->next == FSM_NONE)
+        return;
+    if (t->guard && !t->guard())
+        return;
+
+#if (FSM_TRACE == 1)
+    fsmTrace(fsm, t->next, event);
+#endif
+
+    if (fsm->states[fsm->state].exit)
+        fsm->states[fsm->state].exit();
+    if (t->action)
+        t->action();
+
+    fsm->state = t->next;
+    fsm->time = 0;
+    if (fsm->states[fsm->state].entry)
+        fsm->states[fsm->state].entry();
+} /* void FsmDispatch(fsm_t *fsm, unsigned char event) */
+
+
+
+/*******************************************************************************
+ * FSM Run Function
+ *  - "do" action of the current state, counts the time in state
+ */
+void FsmRun(fsm_t *fsm)
+{
+    if (fsm->time < 0xFFFF)
+        fsm->time++;
+    if (fsm->states[fsm->state].run)
+        fsm->states[fsm->state].run();
+} /* void FsmRun(fsm_t *fsm) */
+
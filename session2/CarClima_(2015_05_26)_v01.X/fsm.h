@@ -0,0 +1,77 @@
+/*
+ * File:   fsm.h
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 6:00 PM
+ */
+
+#ifndef FSM_H
+#define	FSM_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/* table driven state machine
+ *
+ * the application describes the machine only with const tables (ROM):
+ *  - one fsm_state_t per state: entry, exit and do actions
+ *  - one fsm_trans_t per (state, event): next state, guard, action
+ *
+ * FsmDispatch() finds the transition with trans[state * nEvents + event],
+ * O(1) whatever the size of the machine, and runs:
+ *
+ *     guard() true? => exit(old) -> action() -> entry(new)
+ *
+ * every pointer may be 0 (nothing to do / always true), next = FSM_NONE
+ * means the event is ignored in that state
+ */
+
+#define FSM_TRACE   0       /* 1 - each transition is printed on UART */
+
+#define FSM_NONE    (0xFF)  /* no transition */
+
+
+typedef void (*fsm_action_t)(void);
+typedef unsigned char (*fsm_guard_t)(void);
+
+typedef struct
+{
+    fsm_action_t entry;     /* once, when the state is entered */
+    fsm_action_t exit;      /* once, when the state is left */
+    fsm_action_t run;       /* "do", each FsmRun() while in the state */
+} fsm_state_t;
+
+typedef struct
+{
+    unsigned char next;     /* next state, FSM_NONE - event ignored */
+    fsm_guard_t guard;      /* transition taken only if guard() != 0 */
+    fsm_action_t action;    /* between exit and entry */
+} fsm_trans_t;
+
+typedef struct
+{
+    const fsm_state_t *states;  /* [nStates] */
+    const fsm_trans_t *trans;   /* [nStates][nEvents] */
+    unsigned char nStates;
+    unsigned char nEvents;
+    unsigned char state;        /* current state */
+    unsigned int time;          /* FsmRun() calls since the state was entered */
+#if (FSM_TRACE == 1)
+    const char * const *names;  /* state names, 0 - numbers are printed */
+#endif
+} fsm_t;
+
+
+void FsmInit(fsm_t *fsm, unsigned char state);
+void FsmDispatch(fsm_t *fsm, unsigned char event);
+void FsmRun(fsm_t *fsm);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* FSM_H */
+
@@ -9,26 +9,19 @@
 #include <stdlib.h>
 
 #include <p18f8722.h>
-//#include <delays.h>
+#include <delays.h>
 
 #include "lcd.h"
+#include "mcp23s17.h"
+#include "spibus.h"
 
-#define USE_SW_SPI  1
-#if USE_SW_SPI
-#include "swspi.h"
-#else
-#include <spi.h>
-#endif
 
+// LCD control lines on GPIOA of the MCP23S17, DB0-DB7 on GPIOB
+#define LCD_MCP_ADDR    0   /* A2..A0 of the expander */
+#define LCD_RS  0x80
+#define LCD_E   0x40
 
-// this is our chip select (CS) pin according to our pic18 explorer board's connections
-#define CS PORTAbits.RA2
-
-// addresses from MCP23S17's datasheet, think of the IODIR as TRIS and GPIO as PORT for the MCP23S17 (no the PIC micro)
-#define IODIRA_ADDRESS 0x00
-#define IODIRB_ADDRESS 0x01
-#define GPIOA_ADDRESS 0x12
-#define GPIOB_ADDRESS 0x13
+mcp_t lcdMcp;   /* the expander, its free GPA pins are for clima.c */
 
 // configuration bits
 #pragma config OSC = HS         // Oscillator Selection bits (HS oscillator)
@@ -38,62 +31,50 @@
 
 
 
-void setIODIR(char, char);
-void setGPIO(char, char);
 void lcdCommand(char);
+void lcdData(unsigned char);
+unsigned char lcdCell(unsigned char addr);
 
 void LcdInit(void);
 void LcdClear(void);
 void LcdGoTo(char pos);
 void LcdChar(unsigned char letter);
 void LcdWriteString(const char *s);
+void LcdLoadGlyphs(unsigned char code, const unsigned char *rows, unsigned char n);
+char *LcdBar(char *dst, unsigned char cols, unsigned char cells);
+unsigned char LcdCell(char pos, unsigned char letter);
+void LcdShift(void);
+void LcdHome(void);
 
 
-/*
- * used to set the values of the ports ( think of it as when you use a PORT register)
+/* shadow of the DDRAM, LcdChar() sends only the cells that change and moves
+ * the controller address only when a cell is skipped, so a whole screen is
+ * rewritten in place without LcdClear() (1.52ms and a blank frame)
+ *  - the 40 cells of each line, 16 visible, the rest is shown by LcdShift()
  */
-void setGPIO(char address, char value)
-{
-#if USE_SW_SPI // use SW SPI
-    SWSPIClearCS();         // we are about to initiate transmission
-    // pins A2,A1 and A0 of the MCP23S17 chip are equal to 0 because they are grounded
-    // we are just going to be writing so R/W=0 also
-    SWSPIWrite(0x40);       // write command 0b0100[A2][A1][A0][R/W] = 0b01000000 = 0x40
-    SWSPIWrite(address);    // select register by providing address
-    SWSPIWrite(value);      // set value
-    SWSPISetCS(); // we are ending the transmission
-#else // use HW SPI
-    CS=0;                   // we are about to initiate transmission
-    // pins A2,A1 and A0 of the MCP23S17 chip are equal to 0 because they are grounded
-    // we are just going to be writing so R/W=0 also
-    WriteSPI1(0x40);        // write command 0b0100[A2][A1][A0][R/W] = 0b01000000 = 0x40
-    WriteSPI1(address);     // select register by providing address
-    WriteSPI1(value);       // set value
-    CS=1;                   // we are ending the transmission
-#endif
-}
+#define LCD_ROWS        2
+#define LCD_LINE2       0x40    /* DDRAM address of the second line */
+#define LCD_ADDR_NONE   0xFF    /* not a DDRAM cell */
 
-/*
- * used to set the directions of the ports (like when you use TRIS registers)
- * this function is actually identical to setGPIO, but I think a different
- * for setting the port directio helps with keeping the code organized
+unsigned char lcdShadow[LCD_ROWS * LCD_LINE_CELLS]; /* what the DDRAM holds */
+unsigned char lcdAddr = 0;      /* DDRAM address of the next LcdChar() */
+unsigned char lcdHwAddr = 0;    /* address counter of the controller */
+
+
+/* CGRAM glyphs, LCD_CH_BAR1 .. LCD_CH_DOWN, 8 rows of 5 pixels, bit 4 is the
+ * left column; the last row is the cursor line
  */
-void setIODIR(char address, char dir)
+#define LCD_GLYPHS  7
+const unsigned char lcdGlyphs[LCD_GLYPHS][8] =
 {
-#if USE_SW_SPI // use SW SPI
-    SWSPIClearCS();         // we are about to initiate transmission
-    SWSPIWrite(0x40);       // write command (0b0100[A2][A1][A0][R/W]) also equal to 0x40
-    SWSPIWrite(address);    // select IODIRB
-    SWSPIWrite(dir);        // set direction
-    SWSPISetCS();           // we are ending the transmission
-#else // use HW SPI
-    CS=0;                   // we are about to initiate transmission
-    WriteSPI1(0x40);        // write command (0b0100[A2][A1][A0][R/W]) also equal to 0x40
-    WriteSPI1(address);     // select IODIRB
-    WriteSPI1(dir);         // set direction
-    CS=1;                   // we are ending the transmission
-#endif
-}
+    {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10},   /* bar, 1 column */
+    {0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18},   /* bar, 2 columns */
+    {0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C, 0x1C},   /* bar, 3 columns */
+    {0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E},   /* bar, 4 columns */
+    {0x0C, 0x12, 0x12, 0x0C, 0x00, 0x00, 0x00, 0x00},   /* degree */
+    {0x04, 0x0E, 0x15, 0x04, 0x04, 0x04, 0x04, 0x00},   /* up arrow */
+    {0x04, 0x04, 0x04, 0x04, 0x15, 0x0E, 0x04, 0x00}    /* down arrow */
+};
 
 
 /*******************************************************************************
@@ -101,17 +82,49 @@ void setIODIR(char address, char dir)
  */
 void lcdCommand(char command)
 {
-    setGPIO(GPIOA_ADDRESS,0x00); // E=0
+    McpWrite(&lcdMcp, MCP_GPIOA, 0x00); // RS=0, E=0, only sent after data
     //Delay10TCYx(0);
-    setGPIO(GPIOB_ADDRESS, command); // send data
+    McpWrite(&lcdMcp, MCP_GPIOB, command); // send data
     //Delay10TCYx(0);
-    setGPIO(GPIOA_ADDRESS,0x40); // E=1
+    McpWrite(&lcdMcp, MCP_GPIOA, LCD_E); // E=1
     //Delay10TCYx(0);
-    setGPIO(GPIOA_ADDRESS,0x00); // E=0
+    McpWrite(&lcdMcp, MCP_GPIOA, 0x00); // E=0
     //Delay10TCYx(0);
 }
 
 
+/*******************************************************************************
+ * Data Function
+ *  - one byte to DDRAM or CGRAM at the controller address, no shadow
+ */
+void lcdData(unsigned char value)
+{
+    McpWrite(&lcdMcp, MCP_GPIOA, LCD_RS); // RS=1, we going to send data to be displayed, skipped after data
+    //Delay10TCYx(0); // let things settle down
+    McpWrite(&lcdMcp, MCP_GPIOB, value); // send display character, skipped if the same as the last one
+    // Now we need to toggle the enable pin (EN) for the display to take effect
+    McpWrite(&lcdMcp, MCP_GPIOA, LCD_RS | LCD_E); // RS=1, EN=1
+    //Delay10TCYx(0); // let things settle down, this time just needs to be long enough for the chip to detect it as high
+    McpWrite(&lcdMcp, MCP_GPIOA, LCD_RS); // RS=1, EN=0 // this completes the enable pin toggle, RS is kept for the next character
+    //Delay10TCYx(0);
+} /* void lcdData(unsigned char value) */
+
+
+/*******************************************************************************
+ * Cell Function
+ *  - DDRAM address => index in lcdShadow, LCD_ADDR_NONE past the 40 cells
+ */
+unsigned char lcdCell(unsigned char addr)
+{
+    unsigned char col = addr & ~LCD_LINE2;
+
+    if (col >= LCD_LINE_CELLS)
+        return LCD_ADDR_NONE;
+
+    return (addr & LCD_LINE2) ? (col + LCD_LINE_CELLS) : col;
+} /* unsigned char lcdCell(unsigned char addr) */
+
+
 /*******************************************************************************
  * PUBLIC FUNCTIONs                                                        BEGIN
  */
@@ -122,21 +135,15 @@ void lcdCommand(char command)
  */
 void LcdInit(void)
 {
-#if USE_SW_SPI // use SW SPI
-    SWSPIOpen();
-#else // use HW SPI
-    TRISAbits.RA2=0; // our chip select pin needs to be an output so that we can toggle it
-    CS=1; // set CS pin to high, meaning we are sending any information to the MCP23S17 chip
-    // configure SPI: the MCP23S17 chip's max frequency is 10MHz, let's use 10MHz/64 (Note FOSC=10Mhz, our external oscillator)
-    OpenSPI1(SPI_FOSC_64, MODE_10, SMPEND); // frequency, master-slave mode, sampling type
-#endif
+    McpInit(&lcdMcp, LCD_MCP_ADDR); // SpiBusInit() first
+    McpResync(&lcdMcp); // the expander may have kept its registers over a PIC reset
 
     // set LCD pins DB0-DB7 as outputs
-    setIODIR(IODIRB_ADDRESS,0x00);
+    McpWrite(&lcdMcp, MCP_IODIRB, 0x00);
     // set RS and E LCD pins as outputs
-    setIODIR(IODIRA_ADDRESS,0x00);
+    McpWrite(&lcdMcp, MCP_IODIRA, 0x00);
     // RS=0, E=0
-    setGPIO(IODIRA_ADDRESS,0x00);
+    McpWrite(&lcdMcp, MCP_GPIOA, 0x00);
 
     // Function set: 8 bit, 2 lines, 5x8
     lcdCommand(0b00111111);
@@ -144,12 +151,16 @@ void LcdInit(void)
     // NO Cursor, NO blicking
     lcdCommand(0b00001100);
 
-    // clear display
-    lcdCommand(0b00000001);
-
     // entry mode
     lcdCommand(0b00000110);
 
+    // custom characters, once, CGRAM keeps them while powered; before the
+    // clear, a CGRAM address lost in its busy time would put them in DDRAM
+    LcdLoadGlyphs(LCD_CH_BAR1, lcdGlyphs[0], LCD_GLYPHS);
+
+    // clear display, blank shadow
+    LcdClear();
+
 //    // send characters
     LcdWriteString("LCD init ..."); // using the string function
 //
@@ -162,11 +173,22 @@ void LcdInit(void)
 
 /*******************************************************************************
  * Check Inputs Function
+ *  - waits the 1.52ms of the clear, the controller ignores the commands sent
+ *    meanwhile; init only, the screens are rewritten in place
  */
 void LcdClear(void)
 {
+    unsigned char i;
+
     /* clear display */
     lcdCommand(0x01);
+    SpiSync(SPI_DEV_MCP);   // the frames on the wire, then the busy time
+    Delay1KTCYx(4);         // 4000 Tcy = 1.6ms
+
+    for (i = 0; i < LCD_ROWS * LCD_LINE_CELLS; i++)
+        lcdShadow[i] = ' ';
+    lcdAddr = 0;
+    lcdHwAddr = 0;
 } /* void LcdClear(void) */
 
 
@@ -175,8 +197,8 @@ void LcdClear(void)
  */
 void LcdGoTo(char pos)
 {
-    // add 0x80 to be able to use HD44780 position convention
-    lcdCommand(0x80+pos);
+    // only remembered, LcdChar() sends the address if a cell has to change
+    lcdAddr = pos;
 }
 
 
@@ -185,14 +207,25 @@ void LcdGoTo(char pos)
  */
 void LcdChar(unsigned char letter)
 {
-    setGPIO(GPIOA_ADDRESS,0x80); // RS=1, we going to send data to be displayed
-    //Delay10TCYx(0); // let things settle down
-    setGPIO(GPIOB_ADDRESS,letter); // send display character
-    // Now we need to toggle the enable pin (EN) for the display to take effect
-    setGPIO(GPIOA_ADDRESS, 0xc0); // RS=1, EN=1
-    //Delay10TCYx(0); // let things settle down, this time just needs to be long enough for the chip to detect it as high
-    setGPIO(GPIOA_ADDRESS,0x00); // RS=0, EN=0 // this completes the enable pin toggle
-    //Delay10TCYx(0);
+    unsigned char cell = lcdCell(lcdAddr);
+
+    if ((cell != LCD_ADDR_NONE) && (lcdShadow[cell] == letter))
+    {
+        lcdAddr++; // already on the display
+        return;
+    }
+
+    if (lcdHwAddr != lcdAddr)
+    {
+        // add 0x80 to be able to use HD44780 position convention
+        lcdCommand(0x80+lcdAddr);
+    }
+    lcdData(letter);
+
+    if (cell != LCD_ADDR_NONE)
+        lcdShadow[cell] = letter;
+    lcdAddr++;
+    lcdHwAddr = lcdAddr;
 } /* void LcdChar(unsigned char letter) */
 
 
@@ -208,6 +241,97 @@ void LcdWriteString(const char *s)
 } /* void LcdWriteString(char *s) */
 
 
+/*******************************************************************************
+ * Load Glyphs Function
+ *  - n characters of 8 rows from code on (code + n <= LCD_CG_CHARS), the
+ *    CGRAM address increments like the DDRAM one, one command for all
+ *  - the address is left at DDRAM 0
+ */
+void LcdLoadGlyphs(unsigned char code, const unsigned char *rows, unsigned char n)
+{
+    unsigned char i;
+
+    lcdCommand(0x40 | (code << 3)); // set CGRAM address
+    for (i = n << 3; i; i--)
+    {
+        lcdData(*rows++);
+    }
+    lcdCommand(0x80); // back to DDRAM
+    lcdHwAddr = 0;
+} /* void LcdLoadGlyphs(unsigned char code, const unsigned char *rows, unsigned char n) */
+
+
+/*******************************************************************************
+ * Bar Function
+ *  - text of a horizontal bar, cols lit columns out of LCD_BAR_COLS * cells
+ *  - full cells use the ROM block, the partial one a CGRAM glyph
+ *  - ends with '\0', returns its position like the fmt.h functions
+ */
+char *LcdBar(char *dst, unsigned char cols, unsigned char cells)
+{
+    while (cells--)
+    {
+        if (cols >= LCD_BAR_COLS)
+        {
+            *dst++ = LCD_CH_BAR_FULL;
+            cols -= LCD_BAR_COLS;
+        }
+        else if (cols)
+        {
+            *dst++ = LCD_CH_BAR1 - 1 + cols;
+            cols = 0;
+        }
+        else
+        {
+            *dst++ = LCD_CH_BAR_EMPTY;
+        }
+    }
+    *dst = '\0';
+
+    return dst;
+} /* char *LcdBar(char *dst, unsigned char cols, unsigned char cells) */
+
+
+
+/*******************************************************************************
+ * Cell Function
+ *  - one character at pos, 1 if it had to be sent, 0 if the DDRAM has it
+ */
+unsigned char LcdCell(char pos, unsigned char letter)
+{
+    unsigned char cell = lcdCell(pos);
+
+    if ((cell != LCD_ADDR_NONE) && (lcdShadow[cell] == letter))
+        return 0;
+
+    LcdGoTo(pos);
+    LcdChar(letter);
+    return 1;
+} /* unsigned char LcdCell(char pos, unsigned char letter) */
+
+
+/*******************************************************************************
+ * Shift Function
+ *  - the window moves one cell right on both lines (display shift left), one
+ *    command, the DDRAM and the shadow stay as they are
+ */
+void LcdShift(void)
+{
+    lcdCommand(0x18); // cursor/display shift: display, left
+} /* void LcdShift(void) */
+
+
+/*******************************************************************************
+ * Home Function
+ *  - undoes LcdShift(), 1.52ms like the clear, but the DDRAM is kept
+ */
+void LcdHome(void)
+{
+    lcdCommand(0x02); // return home
+    lcdHwAddr = 0;
+} /* void LcdHome(void) */
+
+
 
 /*******************************************************************************
  * PUBLIC FUNCTIONs                                                          END
@@ -19,6 +19,38 @@ extern "C" {
     void LcdGoTo(char pos);
     void LcdChar(unsigned char letter);
     void LcdWriteString(const char *s);
+    void LcdLoadGlyphs(unsigned char code, const unsigned char *rows, unsigned char n);
+    char *LcdBar(char *dst, unsigned char cols, unsigned char cells);
+    unsigned char LcdCell(char pos, unsigned char letter);
+    void LcdShift(void);
+    void LcdHome(void);
+
+
+#define LCD_COLS            16  /* visible cells of a line */
+#define LCD_LINE_CELLS      40  /* DDRAM cells of a line, LcdShift() wraps */
+
+
+/* CGRAM characters, loaded by LcdInit()
+ *  - codes 1..7, code 0 is left free because it ends a string
+ *  - the LCD_STR_ forms are for string literals, as separate literals since
+ *    "\x05C" is one character: "Ti:" LCD_STR_DEGREE "C"
+ */
+#define LCD_CH_BAR1         1   /* 1..4 columns lit, left aligned */
+#define LCD_CH_BAR2         2
+#define LCD_CH_BAR3         3
+#define LCD_CH_BAR4         4
+#define LCD_CH_DEGREE       5
+#define LCD_CH_UP           6
+#define LCD_CH_DOWN         7
+#define LCD_CH_BAR_FULL     0xFF    /* ROM block, all 5 columns */
+#define LCD_CH_BAR_EMPTY    ' '
+
+#define LCD_STR_DEGREE      "\x05"
+#define LCD_STR_UP          "\x06"
+#define LCD_STR_DOWN        "\x07"
+
+#define LCD_CG_CHARS        8   /* CGRAM size, 5x8 characters */
+#define LCD_BAR_COLS        5   /* bar columns per cell */
 
 
 #ifdef	__cplusplus
@@ -0,0 +1,246 @@
+/*
+ * File:   mcp23s17.c
+ * Author: Dragos
+ *
+ * Created on October 20, 2026, 12:10 AM
+ */
+
+#include <p18f8722.h>
+
+#include "spibus.h"
+#include "mcp23s17.h"
+
+
+mcp_t *mcpChip0 = 0;    /* expander at address 0, it takes the broadcast too */
+
+
+/*******************************************************************************
+ * Frame Function
+ *  - one register write, always queued
+ */
+void mcpFrame(unsigned char opcode, unsigned char reg, unsigned char value)
+{
+    unsigned char hdr[3];
+
+    hdr[0] = opcode;
+    hdr[1] = reg;               // select register by providing address
+    hdr[2] = value;             // set value
+    SpiQueue(SPI_DEV_MCP, hdr, 3, 0, 0, 0);
+} /* void mcpFrame(unsigned char opcode, unsigned char reg, unsigned char value) */
+
+
+
+/*******************************************************************************
+ * Address Function
+ *  - IOCON = HAEN to every chip that still answers address 0 only
+ *  - the chip at address 0 takes it as its own IOCON (MIRROR lost), its
+ *    IOCON from the shadow follows at once
+ */
+void mcpAddressing(void)
+{
+    mcpFrame(MCP_OPCODE_WRITE, MCP_IOCON, MCP_IOCON_HAEN);
+    if (mcpChip0)
+        mcpFrame(MCP_OPCODE_WRITE, MCP_IOCON, mcpChip0->shadow[MCP_IOCON]);
+} /* void mcpAddressing(void) */
+
+
+
+/*******************************************************************************
+ * Shadow Index Function
+ *  - GPIO and OLAT are the same latch for a write
+ */
+unsigned char mcpIndex(unsigned char reg)
+{
+    if ((reg == MCP_GPIOA) || (reg == MCP_GPIOB))
+        return reg + (MCP_OLATA - MCP_GPIOA);
+    if (reg == MCP_IOCON + 1)
+        return MCP_IOCON;
+
+    return reg;
+} /* unsigned char mcpIndex(unsigned char reg) */
+
+
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONs                                                        BEGIN
+ */
+
+
+/*******************************************************************************
+ * Init Function
+ *  - addr: A2..A0 of the chip
+ *  - shadow with the power on values (IODIR all inputs, the rest 0) and
+ *    HAEN, that is sent at once
+ *  - SpiBusInit() first
+ */
+void McpInit(mcp_t *m, unsigned char addr)
+{
+    unsigned char i;
+
+    m->addr = addr & MCP_ADDR_MAX;
+
+    for (i = 0; i < MCP_REGS; i++)
+        m->shadow[i] = 0x00;
+    m->shadow[MCP_IODIRA] = 0xFF;
+    m->shadow[MCP_IODIRB] = 0xFF;
+    m->shadow[MCP_IOCON] = MCP_IOCON_HAEN;
+
+    m->intPending = 0;
+    m->inMask = 0;
+    m->inLevel = 0;
+    m->inLock = 0;
+
+    if (m->addr == 0)
+        mcpChip0 = m;
+    mcpAddressing();
+} /* void McpInit(mcp_t *m, unsigned char addr) */
+
+
+/*******************************************************************************
+ * Write Function
+ *  - nothing is sent if the register already has the value
+ */
+void McpWrite(mcp_t *m, unsigned char reg, unsigned char value)
+{
+    unsigned char i = mcpIndex(reg);
+
+    if (m->shadow[i] == value)
+        return;
+
+    m->shadow[i] = value;
+    mcpFrame(MCP_OPCODE_WRITE | (m->addr << 1), reg, value);
+} /* void McpWrite(mcp_t *m, unsigned char reg, unsigned char value) */
+
+
+/*******************************************************************************
+ * Resync Function
+ *  - after a reset of the expander alone, all the written registers again
+ *  - IOCON first, it sets the addressing of the others, then the output
+ *    latches before IODIR turns the pins to outputs
+ */
+void McpResync(mcp_t *m)
+{
+    unsigned char opcode = MCP_OPCODE_WRITE | (m->addr << 1);
+    unsigned char reg;
+
+    mcpAddressing();
+    mcpFrame(opcode, MCP_IOCON, m->shadow[MCP_IOCON]);
+    mcpFrame(opcode, MCP_OLATA, m->shadow[MCP_OLATA]);
+    mcpFrame(opcode, MCP_OLATB, m->shadow[MCP_OLATB]);
+    for (reg = 0; reg < MCP_INTFA; reg++) /* INTF, INTCAP are read only */
+    {
+        if ((reg != MCP_IOCON) && (reg != MCP_IOCON + 1))
+            mcpFrame(opcode, reg, m->shadow[reg]);
+    }
+} /* void McpResync(mcp_t *m) */
+
+
+/*******************************************************************************
+ * Read Function
+ *  - always from the chip: GPIO (pins), INTF, INTCAP change by themselves
+ *  - reading GPIO or INTCAP ends the interrupt
+ *  - the frames queued before go out first, the other devices wait
+ */
+unsigned char McpRead(mcp_t *m, unsigned char reg)
+{
+    unsigned char hdr[2];
+    unsigned char value;
+
+    hdr[0] = MCP_OPCODE_READ | (m->addr << 1);
+    hdr[1] = reg;               // select register by providing address
+    SpiQueue(SPI_DEV_MCP, hdr, 2, 0, &value, 1);    // clock the value in
+    SpiSync(SPI_DEV_MCP);
+
+    return value;
+} /* unsigned char McpRead(mcp_t *m, unsigned char reg) */
+
+
+/*******************************************************************************
+ * Input Init Function
+ *  - mask: GPA pins (MCP_IN_PINS) as button inputs, after LcdInit()
+ *  - GIE is set later, by the timer init
+ *  - INT2 is one line: the expander with buttons, or all of them wired
+ *    together (open drain INT, IOCON.ODR)
+ */
+void McpInInit(mcp_t *m, unsigned char mask)
+{
+    mask &= MCP_IN_PINS;
+    m->inMask = mask;
+
+    McpWrite(m, MCP_IOCON, m->shadow[MCP_IOCON] | MCP_IOCON_MIRROR);
+    McpWrite(m, MCP_IODIRA, m->shadow[MCP_IODIRA] | mask);
+    McpWrite(m, MCP_GPPUA, mask);
+    McpWrite(m, MCP_IPOLA, mask);       /* 1 = pressed in GPIO and INTCAP */
+    McpWrite(m, MCP_INTCONA, 0x00);     /* against the previous value, both edges */
+    /* a button held during reset is no press, the read ends an old interrupt */
+    m->inLevel = McpRead(m, MCP_GPIOA) & mask;
+    m->inLock = 0;
+    McpWrite(m, MCP_GPINTENA, mask);
+
+    /* INTA, active low => RB2/INT2 falling edge */
+    TRISBbits.TRISB2 = 1;
+    INTEDG2 = 0;
+    INT2IF = 0;
+    m->intPending = 0;
+    INT2IE = mask ? 1 : 0;
+} /* void McpInInit(mcp_t *m, unsigned char mask) */
+
+
+/*******************************************************************************
+ * Input ISR Function
+ *  - call it from the interrupt service routine, no SPI here
+ */
+void McpInIsr(mcp_t *m)
+{
+    if (INT2IE && INT2IF)
+    {
+        INT2IF = 0;
+        m->intPending = 1;
+    }
+} /* void McpInIsr(mcp_t *m) */
+
+
+/*******************************************************************************
+ * Input Tick Function
+ *  - call it from the main loop, each 20ms
+ *  - returns the pins with a new level, see McpInLevel()
+ */
+unsigned char McpInTick(mcp_t *m)
+{
+    unsigned char level;
+    unsigned char changed;
+
+    if (m->inLock)
+    {
+        if (--m->inLock)
+            return 0; /* bounces, INT stays low until the read */
+
+        /* end of the lockout, a change hidden in the bounces is not lost */
+        m->intPending = 0;
+        level = McpRead(m, MCP_GPIOA) & m->inMask;
+    }
+    else if (m->intPending)
+    {
+        m->intPending = 0;
+        level = McpRead(m, MCP_INTCAPA) & m->inMask; /* pins at the interrupt */
+    }
+    else
+    {
+        return 0; /* idle, no SPI */
+    }
+
+    changed = level ^ m->inLevel;
+    if (changed)
+    {
+        m->inLevel = level;
+        m->inLock = MCP_LOCKOUT_TICKS;
+    }
+
+    return changed;
+} /* unsigned char McpInTick(mcp_t *m) */
+
+
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONs                                                          END
+ */
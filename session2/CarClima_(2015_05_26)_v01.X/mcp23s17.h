@@ -0,0 +1,114 @@
+/*
+ * File:   mcp23s17.h
+ * Author: Dragos
+ *
+ * Created on October 20, 2026, 12:10 AM
+ */
+
+#ifndef MCP23S17_H
+#define	MCP23S17_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/* MCP23S17 SPI port expanders, the one of the explorer board (the LCD is
+ * on it) has A2..A0 grounded, address 0
+ *
+ * the expanders share SPI_DEV_MCP (one CS, spibus.h), IOCON.HAEN makes each
+ * one answer only the opcode with its A2..A0; one mcp_t per chip
+ *
+ * every register written is kept in RAM, McpWrite() of the value that the
+ * chip already has is not sent; one frame is CS low, opcode, address, value,
+ * queued on the bus, McpRead() waits for the queue of the expanders
+ *
+ * the shadow starts with the power on values of the datasheet, if the
+ * expander is reset alone (brown out, glitch on its RESET pin) McpResync()
+ * sends all the shadow again
+ *
+ * with HAEN off every chip answers address 0 alone: McpInit() and
+ * McpResync() first send IOCON = HAEN with the opcode of address 0, it
+ * wakes the addressing of the chips still at their power on values; the
+ * expander at address 0 takes that frame too, its IOCON from the shadow
+ * (MIRROR, ...) is sent again right after it
+ *
+ * IOCON.BANK = 0: A and B registers of a kind are next to each other
+ *
+ * inputs: the free GPA pins (GPA6/GPA7 are E/RS of the LCD) are push
+ * buttons to ground, pull-ups on, IPOL set so 1 = pressed; INTA (INTB
+ * mirrored) is on RB2/INT2 of the PIC
+ *
+ *   INT2 falling edge      McpInIsr() only notes it, the SPI belongs to the
+ *                          main loop (LCD frames)
+ *   McpInTick()            each tick of the main loop, reads INTCAP (ends the
+ *                          interrupt) only when INT2 came, the change is
+ *                          accepted at once, then the bounces are left on
+ *                          the INT line for MCP_LOCKOUT_TICKS and GPIO is
+ *                          read once at the end
+ *
+ * no button activity - no SPI frame
+ */
+
+#define MCP_OPCODE_WRITE    0x40    // 0b0100[A2][A1][A0][R/W]
+#define MCP_OPCODE_READ     0x41
+#define MCP_ADDR_MAX        7       // A2..A0
+
+#define MCP_IODIRA          0x00    // think of IODIR as TRIS
+#define MCP_IODIRB          0x01
+#define MCP_IPOLA           0x02
+#define MCP_IPOLB           0x03
+#define MCP_GPINTENA        0x04
+#define MCP_GPINTENB        0x05
+#define MCP_DEFVALA         0x06
+#define MCP_DEFVALB         0x07
+#define MCP_INTCONA         0x08
+#define MCP_INTCONB         0x09
+#define MCP_IOCON           0x0A    // same register at 0x0B
+#define MCP_GPPUA           0x0C
+#define MCP_GPPUB           0x0D
+#define MCP_INTFA           0x0E    // read only
+#define MCP_INTFB           0x0F
+#define MCP_INTCAPA         0x10    // read only
+#define MCP_INTCAPB         0x11
+#define MCP_GPIOA           0x12    // think of GPIO as PORT, a write goes to OLAT
+#define MCP_GPIOB           0x13
+#define MCP_OLATA           0x14
+#define MCP_OLATB           0x15
+#define MCP_REGS            0x16
+
+#define MCP_IOCON_MIRROR    0x40    // INTA and INTB are one interrupt line
+#define MCP_IOCON_HAEN      0x08    // A2..A0 pins used, before: all chips are 0
+#define MCP_IN_PINS         0x3F    // GPA0..GPA5, free for inputs
+#define MCP_LOCKOUT_TICKS   (2)     // McpInTick() calls, 2 * 20ms
+
+
+typedef struct
+{
+    unsigned char addr;                 /* A2..A0 */
+    unsigned char shadow[MCP_REGS];     /* value of each register in the chip */
+    volatile unsigned char intPending;  /* INT2 came, INTCAP to read */
+    unsigned char inMask;               /* GPA input pins */
+    unsigned char inLevel;              /* accepted level, 1 = pressed */
+    unsigned char inLock;               /* ticks left in the lockout, 0 - none */
+} mcp_t;
+
+/* accepted level of the input pins in mask, 1 = pressed */
+#define McpInLevel(m, mask) ((m)->inLevel & (mask))
+
+
+void McpInit(mcp_t *m, unsigned char addr);
+void McpWrite(mcp_t *m, unsigned char reg, unsigned char value);
+void McpResync(mcp_t *m);
+unsigned char McpRead(mcp_t *m, unsigned char reg);
+void McpInInit(mcp_t *m, unsigned char mask);
+void McpInIsr(mcp_t *m);
+unsigned char McpInTick(mcp_t *m);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* MCP23S17_H */
+
@@ -0,0 +1,76 @@
+/*
+ * File:   pid.c
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 4:30 PM
+ */
+
+#include "pid.h"
+
+
+
+/*******************************************************************************
+ * PID Init Function
+ */
+void PidInit(pidc_t *pid, q8_8 kp, q8_8 ki, q8_8 kd, int outMin, int outMax)
+{
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+    pid->outMin = outMin;
+    pid->outMax = outMax;
+
+    PidReset(pid, 0);
+} /* void PidInit(...) */
+
+
+
+/*******************************************************************************
+ * PID Reset Function
+ *  - clears the integral term, the next derivative starts from meas
+ */
+void PidReset(pidc_t *pid, q8_8 meas)
+{
+    pid->integ = 0;
+    pid->measPrev = meas;
+} /* void PidReset(pidc_t *pid, q8_8 meas) */
+
+
+
+/*******************************************************************************
+ * PID Update Function
+ *  - one control period, returns the actuator value
+ */
+int PidUpdate(pidc_t *pid, q8_8 setpoint, q8_8 meas)
+{
+    q8_8 err = setpoint - meas;
+    long integMax = (long)pid->outMax << 8;
+    long integMin = (long)pid->outMin << 8;
+    long out;
+
+    /* Q8.8 * Q8.8 = Q16.16, >> 8 => Q8.8 output units */
+    out = ((long)pid->kp * err) >> 8;
+    out -= ((long)pid->kd * (meas - pid->measPrev)) >> 8;
+    pid->measPrev = meas;
+
+    /* integrate only if it does not push a saturated output further */
+    if (   ((out + pid->integ < integMax) || (err < 0))
+        && ((out + pid->integ > integMin) || (err > 0))
+       )
+    {
+        pid->integ += ((long)pid->ki * err) >> 8;
+        if (pid->integ > integMax)
+            pid->integ = integMax;
+        else if (pid->integ < integMin)
+            pid->integ = integMin;
+    }
+
+    out = (out + pid->integ) >> 8;
+    if (out > pid->outMax)
+        return pid->outMax;
+    if (out < pid->outMin)
+        return pid->outMin;
+
+    return (int)out;
+} /* int PidUpdate(pidc_t *pid, q8_8 setpoint, q8_8 meas) */
+
@@ -0,0 +1,59 @@
+/*
+ * File:   pid.h
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 4:30 PM
+ */
+
+#ifndef PID_H
+#define	PID_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/* PID controller in fixed point
+ *
+ * temperatures and gains are Q8.8 (signed 16 bit, 1.0 = 256), the terms are
+ * summed in 32 bit, the output is an integer in [outMin, outMax]
+ *
+ *   out = Kp*e + I - Kd*(meas - measPrev)       e = setpoint - meas
+ *   I  += Ki*e                                   (per PidUpdate() call)
+ *
+ * - derivative on measurement: a setpoint step gives no output kick
+ * - anti-windup: I is clamped to the output range and is not increased
+ *   while the output is saturated in the same direction
+ *
+ * Ki/Kd are per call, PidUpdate() has to be called at a fixed period
+ */
+
+typedef short q8_8;     /* 16 bit, as int of XC8: the host build overflows the same way */
+
+#define Q8_8(x)         ((q8_8)((x) * 256))     /* constants only, no float at run time */
+#define Q8_8_INT(i)     ((q8_8)(i) << 8)
+
+
+typedef struct
+{
+    q8_8 kp;            /* output units per 1.0 of error */
+    q8_8 ki;            /* output units per 1.0 of error, per call */
+    q8_8 kd;            /* output units per 1.0 of measurement change, per call */
+    int outMin;         /* actuator range */
+    int outMax;
+    long integ;         /* integral term, Q8.8 output units */
+    q8_8 measPrev;      /* measurement of the previous call */
+} pidc_t;
+
+
+void PidInit(pidc_t *pid, q8_8 kp, q8_8 ki, q8_8 kd, int outMin, int outMax);
+void PidReset(pidc_t *pid, q8_8 meas);
+int PidUpdate(pidc_t *pid, q8_8 setpoint, q8_8 meas);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* PID_H */
+
@@ -0,0 +1,233 @@
+/*
+ * File:   prof.c
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 9:20 AM
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <p18f8722.h>
+
+#include "prof.h"
+#include "lcd.h"
+#include "uart.h"
+#include "fmt.h"
+
+#if (PROF_EN == 1)
+
+
+/* names printed in the UART report, same order as prof_e */
+const char ProfNames[PROF_MAX][5] =
+{
+    "chk ",     /* checkInputs() */
+    "sm  ",     /* stateMachine() */
+    "out ",     /* updateOutputs() */
+    "lcd ",     /* ScreenTick() */
+    "isr ",     /* interrupt service routine */
+    "pid "      /* PidUpdate() */
+};
+
+prof_t profStat[PROF_MAX];          /* accumulated statistics per task */
+unsigned int profStart[PROF_MAX];   /* Timer3 value at the entry of each task */
+unsigned long profWindow = 0;       /* Timer3 counts elapsed since last reset */
+unsigned int profLast = 0;          /* Timer3 value at the previous frame */
+unsigned char profLcdPage = 0;      /* 1 - diagnostics page is shown on LCD */
+
+char profMsg[48] = {0};             /* used to format the report */
+
+
+
+/*******************************************************************************
+ * Profiler Init Function
+ */
+void ProfInit(void)
+{
+// START - TMR3 setup, free running, no interrupt
+    T3CON = 0;
+    T3CONbits.RD16 = 1;     // 16 bit read/write in one operation
+    T3CONbits.T3CKPS = 0b11;// prescaler 1:8 => timer clock = (10MHz/4) / 8 = 312.5Khz
+    T3CONbits.TMR3CS = 0;   // internal source clock
+    TMR3H = 0;
+    TMR3L = 0;
+    T3CONbits.TMR3ON = 1;   // timer ON
+// END - TMR3 setup
+
+    ProfReset();
+} /* void ProfInit(void) */
+
+
+
+/*******************************************************************************
+ * Profiler Time Stamp Function
+ */
+unsigned int ProfNow(void)
+{
+    unsigned int now;
+    unsigned char gie = GIE;    /* called before initTmr() too, GIE is kept */
+
+    /* the ISR reads TMR3 too, keep TMR3L and the latched TMR3H together */
+    GIE = 0;
+    now = TMR3;
+    GIE = gie;
+
+    return now;
+} /* unsigned int ProfNow(void) */
+
+
+
+/*******************************************************************************
+ * Profiler Reset Function
+ */
+void ProfReset(void)
+{
+    unsigned char i;
+    unsigned char gie = GIE;
+
+    GIE = 0;
+    for (i = 0; i < PROF_MAX; i++)
+    {
+        profStat[i].total = 0;
+        profStat[i].max = 0;
+        profStat[i].calls = 0;
+    }
+    profWindow = 0;
+    profLast = TMR3;
+    GIE = gie;
+} /* void ProfReset(void) */
+
+
+
+/*******************************************************************************
+ * Profiler Accumulate Function
+ */
+void ProfAdd(prof_e id, unsigned int time)
+{
+    profStat[id].total += time;
+    if (time > profStat[id].max)
+        profStat[id].max = time;
+    profStat[id].calls++;
+} /* void ProfAdd(prof_e id, unsigned int time) */
+
+
+
+/*******************************************************************************
+ * Profiler Frame Function
+ *  - called once per main loop cycle (100ms), before Timer3 can overflow twice
+ */
+void ProfFrame(void)
+{
+    unsigned int now = ProfNow();
+
+    profWindow += (unsigned int)(now - profLast);
+    profLast = now;
+} /* void ProfFrame(void) */
+
+
+
+/*******************************************************************************
+ * Profiler Copy Function
+ *  - the statistics of a task in st, the ISR updates its own ones: the 32 bit
+ *    total is copied with the interrupts masked, not torn
+ */
+void profCopy(prof_e id, prof_t *st)
+{
+    unsigned char gie = GIE;
+
+    GIE = 0;
+    *st = profStat[id];
+    GIE = gie;
+} /* void profCopy(prof_e id, prof_t *st) */
+
+
+
+/*******************************************************************************
+ * Profiler Load Function
+ *  - returns the load of a task in 0.1% units, total from profCopy()
+ */
+unsigned int profLoad(unsigned long total)
+{
+    unsigned long window = profWindow / 1000;
+
+    if (window == 0)
+        return 0;
+
+    return (unsigned int)(total / window);
+} /* unsigned int profLoad(unsigned long total) */
+
+
+
+/*******************************************************************************
+ * Profiler UART Report Function
+ *  - one line per task: calls, average and maximum run time (us), load (%),
+ *    average run time in instruction cycles
+ */
+void ProfReport(void)
+{
+    unsigned char i;
+    prof_t st;
+    unsigned int avg;
+    unsigned long avgTcy;   /* cycles per run, e.g. per PID update */
+    unsigned int load;
+
+    UART_puts((char *)"\n\rtask calls   avg(us)  max(us)  load   avg(Tcy)\n\r");
+    for (i = 0; i < PROF_MAX; i++)
+    {
+        profCopy(i, &st);
+        if (st.calls)
+        {
+            avg = (unsigned int)((st.total * PROF_US_PER_COUNT / 10) / st.calls);
+            avgTcy = (st.total * PROF_TCY_PER_COUNT) / st.calls;
+        }
+        else
+        {
+            avg = 0;
+            avgTcy = 0;
+        }
+        load = profLoad(st.total);
+
+        UART_puts((char *)ProfNames[i]);
+        sprintf(profMsg, " %5u   %6u   %6lu   %2u.%u%%  %7lu\n\r",
+                st.calls,
+                avg,
+                (unsigned long)st.max * PROF_US_PER_COUNT / 10,
+                load / 10, load % 10,
+                avgTcy);
+        UART_puts(profMsg);
+    }
+} /* void ProfReport(void) */
+
+
+
+/*******************************************************************************
+ * Profiler LCD Page Function
+ *  - load in % for each task, 99 at most
+ */
+void ProfLcd(void)
+{
+#if (PROF_LCD_PAGE == 1)
+    unsigned char i;
+    prof_t st;
+    unsigned int load;
+
+    LcdGoTo(0); /* first Line */
+    //                 0123456789012345
+    LcdWriteString(   "In Sm Ou Lc Is %");
+
+    LcdGoTo(0x40); /* second Line */
+    for (i = 0; i < PROF_LCD_TASKS; i++)
+    {
+        profCopy(i, &st);
+        load = (profLoad(st.total) + 5) / 10;
+        if (load > 99)
+            load = 99;
+        FmtStr(FmtUint(profMsg, load, 2, ' '), " ");
+        LcdWriteString(profMsg);
+    }
+    LcdWriteString(" ");
+#endif
+} /* void ProfLcd(void) */
+
+
+#endif /* PROF_EN */
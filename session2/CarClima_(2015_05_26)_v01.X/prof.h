@@ -0,0 +1,98 @@
+/*
+ * File:   prof.h
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 9:20 AM
+ */
+
+#ifndef PROF_H
+#define	PROF_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/* CPU load measurement
+ * 1 - per task timing is compiled in, 's' on UART prints the statistics
+ * 0 - every PROF_xxx() macro is empty, nothing is linked
+ */
+#define PROF_EN         0
+#define PROF_LCD_PAGE   1   /* 'd' on UART toggles the diagnostics page on LCD */
+
+
+/* Timer3 runs free with prescaler 1:8 => (10MHz/4)/8 = 312.5kHz => 3.2us/count
+ * it overflows each 65536*3.2us = 209ms, more than one 100ms frame
+ */
+#define PROF_US_PER_COUNT   (32)    /* x0.1us */
+#define PROF_TCY_PER_COUNT  (8)     /* instruction cycles (4/Fosc = 0.4us) */
+
+#define PROF_LCD_TASKS      (PROF_ISR + 1)  /* columns of the LCD page */
+
+
+typedef enum
+{
+    PROF_CHECK_INPUTS = 0,
+    PROF_STATE_MACHINE,
+    PROF_UPDATE_OUTPUTS,
+    PROF_LCD,
+    PROF_ISR,
+    PROF_PID,               /* PidUpdate(), inside PROF_STATE_MACHINE, UART only */
+    PROF_MAX
+} prof_e;
+
+
+typedef struct
+{
+    unsigned long total;    /* Timer3 counts spent in the task since last reset */
+    unsigned int max;       /* longest single run (Timer3 counts) */
+    unsigned int calls;     /* number of runs */
+} prof_t;
+
+
+#if (PROF_EN == 1)
+
+extern prof_t profStat[PROF_MAX];
+extern unsigned int profStart[PROF_MAX];
+extern unsigned char profLcdPage;
+
+/* time stamp the entry of a task */
+#define PROF_BEGIN(id)  (profStart[id] = ProfNow())
+/* time stamp the exit of a task and accumulate */
+#define PROF_END(id)    ProfAdd(id, ProfNow() - profStart[id])
+
+/* same for the interrupt, TMR3 is read directly and no function is called */
+#define PROF_ISR_BEGIN()    (profStart[PROF_ISR] = TMR3)
+#define PROF_ISR_END()                                          \
+    do {                                                        \
+        unsigned int t = TMR3 - profStart[PROF_ISR];            \
+        profStat[PROF_ISR].total += t;                          \
+        if (t > profStat[PROF_ISR].max)                         \
+            profStat[PROF_ISR].max = t;                         \
+        profStat[PROF_ISR].calls++;                             \
+    } while (0)
+
+void ProfInit(void);
+unsigned int ProfNow(void);
+void ProfReset(void);
+void ProfAdd(prof_e id, unsigned int time);
+void ProfFrame(void);
+void ProfReport(void);
+void ProfLcd(void);
+
+#else
+
+#define PROF_BEGIN(id)
+#define PROF_END(id)
+#define PROF_ISR_BEGIN()
+#define PROF_ISR_END()
+
+#endif /* PROF_EN */
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* PROF_H */
+
@@ -0,0 +1,196 @@
+/*
+ * File:   pwm.c
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 1:40 PM
+ */
+
+#include <p18f8722.h>
+
+#include "pwm.h"
+
+
+#define CCP_MODE_PWM            0b00001100  /* PWM mode, P1A/P2A/P3A active high */
+#define CCP_MODE_HIGH_CLR       0b00001001  /* compare: pin high now, low on match */
+
+unsigned int pwmHeatDuty = 0;   /* heat element duty, applied at each TMR1 overflow */
+
+/* duty = 205 + 818 * (demand/255)^1.5, demand 0 => FAN OFF */
+const unsigned int PwmFanCurve[256] =
+{
+       0,  205,  206,  206,  207,  207,  208,  209,  210,  210,  211,  212,  213,  214,  216,  217,
+     218,  219,  220,  222,  223,  224,  226,  227,  229,  230,  232,  233,  235,  236,  238,  240,
+     241,  243,  245,  247,  248,  250,  252,  254,  256,  258,  260,  262,  264,  266,  268,  270,
+     272,  274,  276,  278,  280,  283,  285,  287,  289,  291,  294,  296,  298,  301,  303,  305,
+     308,  310,  313,  315,  318,  320,  323,  325,  328,  330,  333,  335,  338,  341,  343,  346,
+     349,  351,  354,  357,  360,  362,  365,  368,  371,  374,  377,  379,  382,  385,  388,  391,
+     394,  397,  400,  403,  406,  409,  412,  415,  418,  421,  424,  427,  430,  434,  437,  440,
+     443,  446,  450,  453,  456,  459,  462,  466,  469,  472,  476,  479,  482,  486,  489,  493,
+     496,  499,  503,  506,  510,  513,  517,  520,  524,  527,  531,  534,  538,  541,  545,  549,
+     552,  556,  559,  563,  567,  570,  574,  578,  581,  585,  589,  593,  596,  600,  604,  608,
+     612,  615,  619,  623,  627,  631,  635,  639,  642,  646,  650,  654,  658,  662,  666,  670,
+     674,  678,  682,  686,  690,  694,  698,  702,  706,  710,  715,  719,  723,  727,  731,  735,
+     739,  744,  748,  752,  756,  760,  765,  769,  773,  777,  782,  786,  790,  795,  799,  803,
+     808,  812,  816,  821,  825,  829,  834,  838,  843,  847,  852,  856,  861,  865,  869,  874,
+     878,  883,  888,  892,  897,  901,  906,  910,  915,  919,  924,  929,  933,  938,  943,  947,
+     952,  957,  961,  966,  971,  975,  980,  985,  990,  994,  999, 1004, 1009, 1013, 1018, 1023
+};
+
+
+
+/*******************************************************************************
+ * Duty Conversion Function
+ *  - 10 bit duty (0..1023) to TMR2 PWM counts (0..PWM_FAN_COUNTS)
+ */
+unsigned int pwmFanCounts(unsigned int duty)
+{
+    if (duty >= PWM_DUTY_MAX)
+        return PWM_FAN_COUNTS; /* duty > period => pin always high */
+
+    return (unsigned int)(((unsigned long)duty * PWM_FAN_COUNTS) >> 10);
+} /* unsigned int pwmFanCounts(unsigned int duty) */
+
+
+
+/*******************************************************************************
+ * Init PWM Function
+ */
+void PwmInit(void)
+{
+    /* keep the pins as inputs while the modules are configured */
+    TRISCbits.TRISC2 = 1;
+    TRISCbits.TRISC1 = 1;
+    TRISGbits.TRISG0 = 1;
+
+// START - FANs, CCP1/CCP2 PWM on TMR2
+    CCP1CON = CCP_MODE_PWM;
+    CCP2CON = CCP_MODE_PWM;
+    CCPR1L = 0;
+    CCPR2L = 0;
+
+    PR2 = PWM_FAN_PR2;
+    T2CON = 0;
+    T2CONbits.T2CKPS = 0b00;    // prescaler 1:1
+    TMR2IF = 0;
+    T2CONbits.TMR2ON = 1;       // timer ON
+// END - FANs
+
+// START - heat element, CCP3 compare on TMR1
+    LATGbits.LATG0 = 0;
+    CCP3CON = 0;                // module OFF, pin follows LATG0
+    CCPR3 = 0;
+
+    T1CON = 0;
+    T1CONbits.RD16 = 1;         // 16 bit read/write in one operation
+    T1CONbits.T1CKPS = PWM_HEAT_T1CKPS;
+    T1CONbits.TMR1CS = 0;       // internal source clock
+    T1CONbits.T1OSCEN = 0;      // RC0/RC1 are not used by the TMR1 oscillator
+    TMR1H = 0;
+    TMR1L = 0;
+    TMR1IF = 0;
+    TMR1IE = 1;                 // enable TMR1 overflow interrupts
+    PEIE = 1;                   // enable peripheral interrupts
+    T1CONbits.TMR1ON = 1;       // timer ON
+// END - heat element
+
+    /* wait a full PWM period before the outputs are enabled */
+    while (!TMR2IF);
+
+    TRISCbits.TRISC2 = 0;
+    TRISCbits.TRISC1 = 0;
+    TRISGbits.TRISG0 = 0;
+} /* void PwmInit(void) */
+
+
+
+/*******************************************************************************
+ * Set cool FAN duty Function
+ */
+void PwmSetFanCool(unsigned int duty)
+{
+    unsigned int counts = pwmFanCounts(duty);
+
+    /* 8 MSB in CCPR1L, 2 LSB in DC1B, latched at the next TMR2 = PR2 */
+    CCP1CONbits.DC1B = counts & 0x03;
+    CCPR1L = counts >> 2;
+} /* void PwmSetFanCool(unsigned int duty) */
+
+
+
+/*******************************************************************************
+ * Set heat/vent FAN duty Function
+ */
+void PwmSetFanHeatVent(unsigned int duty)
+{
+    unsigned int counts = pwmFanCounts(duty);
+
+    CCP2CONbits.DC2B = counts & 0x03;
+    CCPR2L = counts >> 2;
+} /* void PwmSetFanHeatVent(unsigned int duty) */
+
+
+
+/*******************************************************************************
+ * Set cool FAN demand Function
+ *  - 8 bit demand through the FAN curve, one table read
+ */
+void PwmSetFanCoolLevel(unsigned char level)
+{
+    PwmSetFanCool(PwmFanCurve[level]);
+} /* void PwmSetFanCoolLevel(unsigned char level) */
+
+
+
+/*******************************************************************************
+ * Set heat/vent FAN demand Function
+ */
+void PwmSetFanHeatVentLevel(unsigned char level)
+{
+    PwmSetFanHeatVent(PwmFanCurve[level]);
+} /* void PwmSetFanHeatVentLevel(unsigned char level) */
+
+
+
+/*******************************************************************************
+ * Set heat element duty Function
+ *  - the new duty is used from the next TMR1 window
+ */
+void PwmSetHeat(unsigned int duty)
+{
+    TMR1IE = 0;
+    pwmHeatDuty = duty;
+    TMR1IE = 1;
+} /* void PwmSetHeat(unsigned int duty) */
+
+
+
+/*******************************************************************************
+ * PWM Interrupt Function
+ *  - call it from the interrupt service routine, start of each heat window
+ */
+void PwmIsr(void)
+{
+    if (TMR1IE && TMR1IF)
+    {
+        TMR1IF = 0;     // clear interrupt flag
+
+        CCP3CON = 0;    // module OFF, pin follows LATG0
+        if (pwmHeatDuty == 0)
+        {
+            LATGbits.LATG0 = 0;
+        }
+        else if (pwmHeatDuty >= PWM_DUTY_MAX)
+        {
+            LATGbits.LATG0 = 1;
+        }
+        else
+        {
+            /* 10 bit duty => 16 bit compare value on TMR1
+             * duty 1 => 64 counts, far after TMR1 at this point, so the
+             * compare match is never missed
+             */
+            CCPR3 = pwmHeatDuty << 6;
+            CCP3CON = CCP_MODE_HIGH_CLR;
+        }
+    }
+} /* void PwmIsr(void) */
@@ -0,0 +1,68 @@
+/*
+ * File:   pwm.h
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 1:40 PM
+ */
+
+#ifndef PWM_H
+#define	PWM_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/*
+ * HW PWM outputs
+ *  cool FAN      - CCP1 (RC2), PWM mode, TMR2
+ *  heat/vent FAN - CCP2 (RC1), PWM mode, TMR2
+ *  heat element  - CCP3 (RG0), compare mode, TMR1 (slow time proportioning)
+ *
+ * T3CON.T3CCP2:T3CCP1 = 00 keeps TMR1/TMR2 as time base of all CCP modules
+ */
+
+#define PWM_FOSC            (10000000UL)    /* oscillator (Hz) */
+
+/* FAN carrier, above the audible range
+ * PWM period = (PR2+1) * 4 * Tosc * TMR2 prescaler (1:1)
+ */
+#define PWM_FAN_FREQ        (20000UL)       /* (Hz) */
+#define PWM_FAN_PR2         (PWM_FOSC/(4*PWM_FAN_FREQ) - 1)
+#define PWM_FAN_COUNTS      (4*(PWM_FAN_PR2+1))   /* duty counts for 100% */
+
+#if (PWM_FAN_PR2 > 255) || (PWM_FAN_PR2 < 3)
+#error "PWM_FAN_FREQ out of range for TMR2 with prescaler 1:1"
+#endif
+
+/* heat element window = 65536 * 4 * Tosc * TMR1 prescaler
+ * 0b11 => 1:8 => 209.7ms, the pin is driven high at TMR1 overflow and low by
+ * the compare match
+ */
+#define PWM_HEAT_T1CKPS     (0b11)
+
+#define PWM_DUTY_MAX        (1023)          /* 10 bit duty, 1023 = always ON */
+
+
+/* FAN curve, 8 bit demand (0..255) => 10 bit duty
+ * below ~20% duty the FANs stall, so any demand starts them at 20% and the
+ * rest of the range follows (demand/255)^1.5 for a slow, quiet low end
+ */
+extern const unsigned int PwmFanCurve[256];
+
+
+void PwmInit(void);
+void PwmSetFanCool(unsigned int duty);
+void PwmSetFanHeatVent(unsigned int duty);
+void PwmSetHeat(unsigned int duty);
+void PwmSetFanCoolLevel(unsigned char level);
+void PwmSetFanHeatVentLevel(unsigned char level);
+void PwmIsr(void);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* PWM_H */
+
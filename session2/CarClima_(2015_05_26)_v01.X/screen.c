@@ -0,0 +1,223 @@
+/*
+ * File:   screen.c
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 11:20 PM
+ */
+
+#include "lcd.h"
+#include "screen.h"
+
+
+#define SCR_ROWS        2
+#define SCR_LINE2       0x40    /* DDRAM address of the second line */
+#define SCR_HOLD_TICKS  SCREEN_TICKS(1000)  /* still time before the first marquee step */
+
+const screen_page_t *scrPages;  /* page table, usually a const in ROM */
+unsigned char scrCount = 0;     /* pages in the table, 0 - ScreenInit() not called */
+unsigned char scrPage = 0;      /* page on the LCD */
+unsigned int scrTime = 0;       /* ticks left on the page, 0 - no rotation */
+unsigned char scrRedraw = 0;    /* ticks to the next draw() */
+unsigned char scrScroll = 0;    /* ticks to the next marquee step */
+unsigned char scrPos = 0;       /* next cell to send, line 1 then line 2 */
+unsigned char scrWidth = 0;     /* cells sent per line, LCD_COLS or LCD_LINE_CELLS */
+unsigned char scrLong = 0;      /* a line is longer than LCD_COLS, marquee */
+unsigned char scrShift = 0;     /* display shift steps, SCREEN_SHIFT pages */
+unsigned char scrHome = 0;      /* LcdHome() sent, the LCD is busy 1.52ms */
+
+char scrText[SCR_ROWS][SCREEN_LINE_MAX + 1];    /* text of the page */
+unsigned char scrLen[SCR_ROWS];                 /* length of the lines */
+unsigned char scrOffset[SCR_ROWS];              /* window marquee step of the lines */
+
+
+
+/*******************************************************************************
+ * Draw Function
+ *  - new text of the page, the cells are sent by the next ticks
+ */
+void scrDraw(void)
+{
+    const screen_page_t *pg = &scrPages[scrPage];
+    unsigned char row;
+    unsigned char len;
+
+    pg->draw(scrText[0], scrText[1]);
+
+    scrLong = 0;
+    for (row = 0; row < SCR_ROWS; row++)
+    {
+        len = 0;
+        while (scrText[row][len])
+            len++;
+        scrLen[row] = len;
+
+        if (len > LCD_COLS)
+            scrLong = 1;
+        if (scrOffset[row] >= len + SCREEN_GAP)
+            scrOffset[row] = 0; /* the text got shorter */
+    }
+
+    scrWidth = (pg->flags & SCREEN_SHIFT) ? LCD_LINE_CELLS : LCD_COLS;
+    scrPos = 0;
+} /* void scrDraw(void) */
+
+
+
+/*******************************************************************************
+ * Character Function
+ *  - what the cell col of row shows, blanks after the text
+ */
+char scrChar(unsigned char row, unsigned char col)
+{
+    unsigned char len = scrLen[row];
+
+    if ((len > LCD_COLS) && (scrWidth == LCD_COLS))
+    {
+        /* window marquee: text, SCREEN_GAP blanks, text again */
+        col += scrOffset[row];
+        if (col >= len + SCREEN_GAP)
+            col -= len + SCREEN_GAP;
+    }
+
+    return (col < len) ? scrText[row][col] : ' ';
+} /* char scrChar(unsigned char row, unsigned char col) */
+
+
+
+/*******************************************************************************
+ * Marquee Step Function
+ */
+void scrStep(void)
+{
+    unsigned char row;
+
+    if (scrWidth == LCD_LINE_CELLS)
+    {
+        /* the whole DDRAM line is already written, one command */
+        LcdShift();
+        if (++scrShift == LCD_LINE_CELLS)
+            scrShift = 0;
+        return;
+    }
+
+    for (row = 0; row < SCR_ROWS; row++)
+    {
+        if (scrLen[row] > LCD_COLS)
+        {
+            if (++scrOffset[row] == scrLen[row] + SCREEN_GAP)
+                scrOffset[row] = 0;
+        }
+    }
+    scrPos = 0; /* send the window again, the same cells are skipped */
+} /* void scrStep(void) */
+
+
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONs                                                        BEGIN
+ */
+
+
+/*******************************************************************************
+ * Init Function
+ *  - pages of the rotation, the first one is shown
+ */
+void ScreenInit(const screen_page_t *pages, unsigned char n)
+{
+    scrPages = pages;
+    scrCount = n;
+    ScreenShow(0);
+} /* void ScreenInit(const screen_page_t *pages, unsigned char n) */
+
+
+/*******************************************************************************
+ * Show Function
+ *  - page at once, its time starts again
+ */
+void ScreenShow(unsigned char page)
+{
+    if (page >= scrCount)
+        return;
+
+    if (scrShift)
+    {
+        LcdHome(); /* the new page starts at DDRAM 0 */
+        scrShift = 0;
+        scrHome = 1; /* no cell before the next tick, it would be lost */
+    }
+
+    scrPage = page;
+    scrTime = scrPages[page].time;
+    scrOffset[0] = 0;
+    scrOffset[1] = 0;
+    scrScroll = SCR_HOLD_TICKS;
+    scrRedraw = SCREEN_REDRAW_TICKS;
+    scrDraw();
+} /* void ScreenShow(unsigned char page) */
+
+
+/*******************************************************************************
+ * Redraw Function
+ *  - new text now, e.g. after someone else wrote on the LCD
+ */
+void ScreenRedraw(void)
+{
+    if (scrCount)
+        scrDraw();
+} /* void ScreenRedraw(void) */
+
+
+/*******************************************************************************
+ * Tick Function
+ *  - each SCREEN_TICK_MS from the main loop, SCREEN_CELLS_TICK cells at most
+ */
+void ScreenTick(void)
+{
+    unsigned char budget = SCREEN_CELLS_TICK;
+    unsigned char row;
+    unsigned char col;
+
+    if (scrCount == 0)
+        return;
+
+    /* rotation */
+    if (scrTime && (--scrTime == 0))
+        ScreenShow((scrPage + 1 < scrCount) ? scrPage + 1 : 0);
+
+    /* new values */
+    if (--scrRedraw == 0)
+    {
+        scrRedraw = SCREEN_REDRAW_TICKS;
+        scrDraw();
+    }
+
+    /* return home keeps the controller busy, a cell written now is ignored
+     * while the shadow of lcd.c takes it as shown: one tick (20ms) of rest */
+    if (scrHome)
+    {
+        scrHome = 0;
+        return;
+    }
+
+    /* changed cells, lcd.c skips the ones already shown */
+    while (budget && (scrPos < (scrWidth << 1)))
+    {
+        row = (scrPos >= scrWidth);
+        col = row ? scrPos - scrWidth : scrPos;
+        budget -= LcdCell((row ? SCR_LINE2 : 0) + col, scrChar(row, col));
+        scrPos++;
+    }
+
+    /* marquee, once the text is all on the LCD */
+    if (scrLong && (scrPos == (scrWidth << 1)) && (--scrScroll == 0))
+    {
+        scrScroll = SCREEN_SCROLL_TICKS;
+        scrStep();
+    }
+} /* void ScreenTick(void) */
+
+
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONs                                                          END
+ */
@@ -0,0 +1,64 @@
+/*
+ * File:   screen.h
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 11:20 PM
+ */
+
+#ifndef SCREEN_H
+#define	SCREEN_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/* LCD pages on top of lcd.c, rotated by time, drawn a few cells at a time
+ *
+ * a page is a draw function that writes its two lines as text (RAM only),
+ * ScreenTick() runs from the scheduler each SCREEN_TICK_MS and
+ *
+ *   - calls draw() when the page is entered and each SCREEN_REDRAW_TICKS
+ *   - sends at most SCREEN_CELLS_TICK changed cells (lcd.c skips the others)
+ *   - moves a line longer than LCD_COLS one cell each SCREEN_SCROLL_TICKS
+ *   - goes to the next page after time ticks
+ *
+ * marquee of the lines longer than LCD_COLS:
+ *   SCREEN_SHIFT   both lines are written once as 40 cell loops (DDRAM), each
+ *                  step is one display shift command (LcdShift()), the two
+ *                  lines move together
+ *   0              the 16 cell window is rewritten, short lines stay still
+ *
+ * needs lcd.h (LCD_COLS, LCD_LINE_CELLS) included before
+ */
+
+#define SCREEN_TICK_MS      20      /* ScreenTick() period */
+#define SCREEN_TICKS(ms)    ((ms) / SCREEN_TICK_MS)
+#define SCREEN_CELLS_TICK   4       /* cells sent per tick, 32 in 160ms */
+#define SCREEN_REDRAW_TICKS SCREEN_TICKS(100)
+#define SCREEN_SCROLL_TICKS SCREEN_TICKS(300)
+#define SCREEN_GAP          3       /* blanks between the end and the start of a window marquee */
+#define SCREEN_LINE_MAX     LCD_LINE_CELLS  /* longest line text */
+
+#define SCREEN_SHIFT        0x01    /* flags: marquee with the display shift */
+
+typedef struct
+{
+    void (*draw)(char *line1, char *line2); /* '\0' ended, SCREEN_LINE_MAX at most */
+    unsigned int time;      /* ticks on the page, 0 - stays until ScreenShow() */
+    unsigned char flags;    /* SCREEN_SHIFT */
+} screen_page_t;
+
+
+void ScreenInit(const screen_page_t *pages, unsigned char n);
+void ScreenShow(unsigned char page);
+void ScreenRedraw(void);
+void ScreenTick(void);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* SCREEN_H */
+
@@ -0,0 +1,263 @@
+/*
+ * File:   settings.c
+ * Author: Dragos
+ *
+ * Created on October 20, 2026, 2:30 AM
+ */
+
+#include <p18f8722.h>
+
+#include "settings.h"
+
+
+#define STG_SEQ         0       /* offsets in a slot */
+#define STG_DATA        2
+#define STG_CRC         (SETTINGS_SLOT - 1)
+
+unsigned char stgWork[SETTINGS_SIZE];   /* last settings of SettingsTick() */
+unsigned char stgSaved[SETTINGS_SIZE];  /* settings in the newest slot */
+unsigned char stgHold = 0;              /* seconds to the write, 0 - none */
+unsigned char stgImage[SETTINGS_SLOT];  /* slot being written */
+unsigned char stgPos = SETTINGS_SLOT;   /* next byte to write, SETTINGS_SLOT - none */
+unsigned char stgSlot = 0;              /* next slot */
+unsigned int stgSeq = 0;                /* sequence of the next slot */
+
+
+
+/*******************************************************************************
+ * EEPROM Read Function
+ */
+unsigned char stgRead(unsigned int addr)
+{
+    EEADRH = addr >> 8;
+    EEADR = addr & 0xFF;
+    EECON1bits.EEPGD = 0;   // data EEPROM
+    EECON1bits.CFGS = 0;
+    EECON1bits.RD = 1;
+
+    return EEDATA;
+} /* unsigned char stgRead(unsigned int addr) */
+
+
+
+/*******************************************************************************
+ * EEPROM Write Function
+ *  - starts the write cycle, EECON1bits.WR is 1 until it ends
+ */
+void stgWrite(unsigned int addr, unsigned char value)
+{
+    EEADRH = addr >> 8;
+    EEADR = addr & 0xFF;
+    EEDATA = value;
+    EECON1bits.EEPGD = 0;   // data EEPROM
+    EECON1bits.CFGS = 0;
+    EECON1bits.WREN = 1;
+
+    GIE = 0;                /* the unlock sequence may not be cut */
+    EECON2 = 0x55;
+    EECON2 = 0xAA;
+    EECON1bits.WR = 1;
+    GIE = 1;
+
+    EECON1bits.WREN = 0;    // the started cycle goes on
+} /* void stgWrite(unsigned int addr, unsigned char value) */
+
+
+
+/*******************************************************************************
+ * CRC Function
+ *  - CRC-8, polynomial 0x07, from 0xFF; an erased slot (all 0xFF) is bad
+ */
+unsigned char stgCrc(const unsigned char *p, unsigned char n)
+{
+    unsigned char crc = 0xFF;
+    unsigned char bit;
+
+    while (n--)
+    {
+        crc ^= *p++;
+        for (bit = 0; bit < 8; bit++)
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : (crc << 1);
+    }
+
+    return crc;
+} /* unsigned char stgCrc(const unsigned char *p, unsigned char n) */
+
+
+
+/*******************************************************************************
+ * Same Function
+ *  - 1 if the settings a and b are equal
+ */
+unsigned char stgSame(const unsigned char *a, const unsigned char *b)
+{
+    unsigned char i;
+
+    for (i = 0; i < SETTINGS_SIZE; i++)
+    {
+        if (a[i] != b[i])
+            return 0;
+    }
+
+    return 1;
+} /* unsigned char stgSame(const unsigned char *a, const unsigned char *b) */
+
+
+
+/*******************************************************************************
+ * Sequence Function
+ *  - the sequence of slot, 2 reads
+ */
+unsigned int stgSeqOf(unsigned char slot)
+{
+    unsigned int addr = (unsigned int)slot * SETTINGS_SLOT + STG_SEQ;
+
+    return stgRead(addr) | ((unsigned int)stgRead(addr + 1) << 8);
+} /* unsigned int stgSeqOf(unsigned char slot) */
+
+
+
+/*******************************************************************************
+ * Newest Function
+ *  - the slot with the highest sequence, only the sequences are read; the
+ *    sequences of the ring are close, the difference tells the newest
+ */
+unsigned char stgNewest(void)
+{
+    unsigned char slot;
+    unsigned char newest = 0;
+    unsigned int seq;
+    unsigned int best = stgSeqOf(0);
+
+    for (slot = 1; slot < SETTINGS_SLOTS; slot++)
+    {
+        seq = stgSeqOf(slot);
+        if ((short)(seq - best) > 0)  /* 16 bit, on the host too */
+        {
+            best = seq;
+            newest = slot;
+        }
+    }
+
+    return newest;
+} /* unsigned char stgNewest(void) */
+
+
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONs                                                        BEGIN
+ */
+
+
+/*******************************************************************************
+ * Load Function
+ *  - the settings of the newest good slot in data, returns 1
+ *  - returns 0 and leaves data alone if there is none (new chip)
+ *  - the CRC of the newest slot only; a bad one (cut by a power off) goes
+ *    back one slot in the ring, the save before it
+ */
+unsigned char SettingsLoad(unsigned char *data)
+{
+    unsigned char slot = stgNewest();
+    unsigned char n;
+    unsigned char i;
+    unsigned int addr;
+
+    for (n = 0; n < SETTINGS_SLOTS; n++)
+    {
+        addr = (unsigned int)slot * SETTINGS_SLOT;
+        for (i = 0; i < SETTINGS_SLOT; i++)
+            stgImage[i] = stgRead(addr++);
+
+        if (stgCrc(stgImage, STG_CRC) == stgImage[STG_CRC])
+            break;
+
+        slot = slot ? slot - 1 : SETTINGS_SLOTS - 1;
+    }
+
+    if (n == SETTINGS_SLOTS)
+        return 0;
+
+    stgSeq = stgImage[STG_SEQ] | ((unsigned int)stgImage[STG_SEQ + 1] << 8);
+    stgSlot = slot;
+    for (i = 0; i < SETTINGS_SIZE; i++)
+        stgSaved[i] = stgImage[STG_DATA + i];
+
+    for (i = 0; i < SETTINGS_SIZE; i++)
+    {
+        stgWork[i] = stgSaved[i];
+        data[i] = stgSaved[i];
+    }
+    if (++stgSlot == SETTINGS_SLOTS)
+        stgSlot = 0;
+    stgSeq++;
+
+    return 1;
+} /* unsigned char SettingsLoad(unsigned char *data) */
+
+
+/*******************************************************************************
+ * Tick Function
+ *  - each second, the settings in RAM
+ *  - saved after SETTINGS_HOLD_TIME without a change
+ */
+void SettingsTick(const unsigned char *data)
+{
+    unsigned char i;
+
+    if (!stgSame(data, stgWork))
+    {
+        for (i = 0; i < SETTINGS_SIZE; i++)
+            stgWork[i] = data[i];
+        stgHold = SETTINGS_HOLD_TIME;
+        return;
+    }
+
+    if ((stgHold == 0) || (--stgHold != 0))
+        return;
+
+    if (stgPos != SETTINGS_SLOT)
+    {
+        stgHold = 1; /* a slot is being written, next second */
+        return;
+    }
+
+    if (stgSame(stgWork, stgSaved))
+        return; /* changed and back again */
+
+    stgImage[STG_SEQ] = stgSeq & 0xFF;
+    stgImage[STG_SEQ + 1] = stgSeq >> 8;
+    for (i = 0; i < SETTINGS_SIZE; i++)
+    {
+        stgImage[STG_DATA + i] = stgWork[i];
+        stgSaved[i] = stgWork[i];
+    }
+    stgImage[STG_CRC] = stgCrc(stgImage, STG_CRC);
+    stgPos = 0;
+} /* void SettingsTick(const unsigned char *data) */
+
+
+/*******************************************************************************
+ * Task Function
+ *  - call it from the main loop, one byte when the EEPROM is free
+ */
+void SettingsTask(void)
+{
+    if ((stgPos == SETTINGS_SLOT) || EECON1bits.WR)
+        return;
+
+    stgWrite((unsigned int)stgSlot * SETTINGS_SLOT + stgPos, stgImage[stgPos]);
+
+    if (++stgPos == SETTINGS_SLOT)
+    {
+        if (++stgSlot == SETTINGS_SLOTS)
+            stgSlot = 0;
+        stgSeq++;
+    }
+} /* void SettingsTask(void) */
+
+
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONs                                                          END
+ */
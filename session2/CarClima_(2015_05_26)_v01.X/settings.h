@@ -0,0 +1,54 @@
+/*
+ * File:   settings.h
+ * Author: Dragos
+ *
+ * Created on October 20, 2026, 2:30 AM
+ */
+
+#ifndef SETTINGS_H
+#define	SETTINGS_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/* settings kept over power off in the data EEPROM of the PIC (1024 bytes)
+ *
+ * the working copy is in RAM (the caller's variables), SettingsTick() gets
+ * it each second and writes it only after SETTINGS_HOLD_TIME without a
+ * change: turning the set temperature from 21 to 30 is one write, not 9
+ *
+ * each write goes to the next slot, the slots are used in a ring so each
+ * cell is written once every SETTINGS_SLOTS saves
+ *
+ *   slot   0,1     sequence (16 bit, little end.), the newest is the highest
+ *          2..6    the caller's SETTINGS_SIZE bytes
+ *          7       CRC-8 (0x07, from 0xFF) of bytes 0..6
+ *
+ * SettingsLoad() reads only the sequences at boot (256 bytes) and checks
+ * the CRC of the newest slot, some 3ms (Tcy 0.4us); a slot cut by a power
+ * off has a bad CRC, the one before it in the ring is loaded; a new chip
+ * (no good slot) is the only one that costs all the slots, some 40ms
+ *
+ * an EEPROM byte write takes some 4ms, SettingsTask() starts one when the
+ * previous one is done, nothing waits
+ */
+
+#define SETTINGS_SIZE       5
+#define SETTINGS_SLOT       (SETTINGS_SIZE + 3)
+#define SETTINGS_SLOTS      (1024 / SETTINGS_SLOT)
+#define SETTINGS_HOLD_TIME  (10)        // time (s)
+
+
+unsigned char SettingsLoad(unsigned char *data);
+void SettingsTick(const unsigned char *data);
+void SettingsTask(void);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* SETTINGS_H */
+
@@ -0,0 +1,158 @@
+/*
+ * File:   bcdbench.c
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 10:30 PM
+ *
+ * host check and benchmark of bcd.c: every 8 and 16 bit value is compared
+ * with the division, then the three ways to get the digits are timed
+ *
+ *   div    - x % 10, x / 10 per digit with the shift/subtract loop of the
+ *            XC8 ___lwdiv/___lwmod routines (the PIC18 has no divider)
+ *   sub    - subtract 10000, 1000, 100, 10 (the old fmt.c loop)
+ *   bcd    - Bcd16(), multiply by 205 and shift
+ *
+ * only the ratios mean something, the PC runs the loops much faster than the
+ * PIC18; the real cycles are read on the board with PROF_EN = 1
+ *
+ * build and run on the PC, from the project directory:
+ *   gcc -O2 -I. sim/bcdbench.c bcd.c -o bcdbench
+ *   ./bcdbench
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "bcd.h"
+
+
+#define BENCH_ROUNDS    (200)   /* times all the 65536 values are converted */
+
+
+volatile unsigned char benchSink;   /* the compiler must not drop the work */
+
+
+/* ___lwdiv / ___lwmod: one bit of quotient per step */
+unsigned int lwdiv(unsigned int dividend, unsigned int divisor, unsigned int *rem)
+{
+    unsigned int quot = 0;
+    unsigned char counter = 1;
+
+    while ((divisor & 0x8000) == 0)
+    {
+        divisor <<= 1;
+        counter++;
+    }
+    do
+    {
+        quot <<= 1;
+        if (divisor <= dividend)
+        {
+            dividend -= divisor;
+            quot |= 1;
+        }
+        divisor >>= 1;
+    } while (--counter != 0);
+
+    *rem = dividend;
+    return quot;
+}
+
+void digitsDiv(unsigned int val, unsigned char *d)
+{
+    signed char i;
+    unsigned int rem;
+
+    for (i = 4; i >= 0; i--)
+    {
+        val = lwdiv(val, 10, &rem);
+        d[i] = (unsigned char)rem;
+    }
+}
+
+void digitsSub(unsigned int val, unsigned char *d)
+{
+    static const unsigned int pow10[5] = { 10000, 1000, 100, 10, 1 };
+    unsigned char i;
+
+    for (i = 0; i < 5; i++)
+    {
+        d[i] = 0;
+        while (val >= pow10[i])
+        {
+            val -= pow10[i];
+            d[i]++;
+        }
+    }
+}
+
+
+/*******************************************************************************
+ * Check Function
+ *  - returns the number of wrong conversions
+ */
+unsigned long benchCheck(void)
+{
+    unsigned long v;
+    unsigned long bad = 0;
+    unsigned char d[5];
+    unsigned char r[5];
+    unsigned char i;
+
+    for (v = 0; v < 65536; v++)
+    {
+        Bcd16((unsigned int)v, d);
+        digitsDiv((unsigned int)v, r);
+        for (i = 0; i < 5; i++)
+            if (d[i] != r[i])
+                bad++;
+
+        if (v < 256)
+        {
+            Bcd8((unsigned char)v, d);
+            for (i = 0; i < 3; i++)
+                if (d[i] != r[i + 2])
+                    bad++;
+        }
+    }
+
+    return bad;
+} /* unsigned long benchCheck(void) */
+
+
+/*******************************************************************************
+ * Time Function
+ *  - ns per conversion
+ */
+double benchTime(void (*conv)(unsigned int, unsigned char *))
+{
+    clock_t start;
+    unsigned long v;
+    unsigned int round;
+    unsigned char d[5];
+
+    start = clock();
+    for (round = 0; round < BENCH_ROUNDS; round++)
+    {
+        for (v = 0; v < 65536; v++)
+        {
+            conv((unsigned int)v, d);
+            benchSink = d[0] ^ d[4];
+        }
+    }
+
+    return (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / (BENCH_ROUNDS * 65536.0);
+} /* double benchTime(...) */
+
+
+int main(void)
+{
+    unsigned long bad = benchCheck();
+
+    printf("check: %lu wrong digits (Bcd8 0..255, Bcd16 0..65535)\n", bad);
+    printf("div: %6.2f ns\n", benchTime(digitsDiv));
+    printf("sub: %6.2f ns\n", benchTime(digitsSub));
+    printf("bcd: %6.2f ns\n", benchTime(Bcd16));
+
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,319 @@
+/*
+ * File:   climasim.c
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 5:15 PM
+ *
+ * host simulation: the clima sources in closed loop with the cabin model
+ * (thermal.c), every cycle is run with the real 100ms main cycle and its
+ * 100 TMR0 interrupts
+ *
+ * build and run on the PC, from the project directory:
+ *   gcc -DCLIMA_SIM -Isim -I. sim/climasim.c sim/thermal.c clima.c pid.c pwm.c fsm.c debounce.c gesture.c extint.c fmt.c bcd.c screen.c -o climasim
+ *   ./climasim          - summary of every drive cycle
+ *   ./climasim -v       - plus a trace line each 60s
+ */
+
+#define SIM_REGS_DEFINE
+#include <p18f8722.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "clima.h"
+#include "pwm.h"
+#include "fsm.h"
+#include "thermal.h"
+#include "mcp23s17.h"
+
+
+#define SIM_DT          (0.1)   /* main cycle (s), TIMER_CYCLE of clima.c */
+#define SIM_TICKS       (100)   /* 1ms TMR0 interrupts in one main cycle */
+#define SIM_TEMP_MIN    (21)    /* TEMP_MIN of clima.c, pot => set temperature */
+#define SIM_BAND        (0.5)   /* settled: |Tin - Tset| within (*C) */
+#define SIM_TRACE       (60.0)  /* trace period with -v (s) */
+
+/* clima.c */
+extern fsm_t climaFsm;
+void init(void);
+void climaCycle(void);
+void ISR(void);
+
+/* pwm.c */
+extern unsigned int pwmHeatDuty;
+
+
+/* drive cycle event: at time t the driver or the road changes something
+ * the button is held for one whole cycle, the press and the release raise INT0
+ * like on the board
+ */
+typedef struct
+{
+    double t;                   /* s from the start of the cycle */
+    double tOut;                /* outside temperature (*C) */
+    unsigned char setTemp;      /* 21..36 *C, 0 = unchanged */
+    unsigned char button;       /* 1 - ON/OFF button pressed */
+} simEvent_t;
+
+typedef struct
+{
+    const char *name;
+    double tIn;                 /* cabin temperature at start (*C) */
+    double duration;            /* s */
+    const simEvent_t *events;
+    unsigned char nEvents;
+} simCycle_t;
+
+
+/* parked in the cold, switched ON and set to 24*C */
+const simEvent_t simWinter[] =
+{
+    {    0.0,  -5.0, 24, 0 },
+    {    1.0,  -5.0,  0, 1 },
+};
+
+/* parked in the sun, cabin much hotter than outside */
+const simEvent_t simSummer[] =
+{
+    {    0.0,  32.0, 22, 0 },
+    {    1.0,  32.0,  0, 1 },
+};
+
+/* driver changes the set temperature up and down */
+const simEvent_t simSteps[] =
+{
+    {    0.0,  10.0, 22, 0 },
+    {    1.0,  10.0,  0, 1 },
+    { 1200.0,  10.0, 26, 0 },
+    { 2400.0,  10.0, 21, 0 },
+};
+
+/* from a cold morning into a hot afternoon */
+const simEvent_t simWeather[] =
+{
+    {    0.0,   5.0, 22, 0 },
+    {    1.0,   5.0,  0, 1 },
+    { 1800.0,  30.0,  0, 0 },
+};
+
+#define SIM_CYCLE(name, tIn, duration, ev) { name, tIn, duration, ev, sizeof(ev) / sizeof(ev[0]) }
+
+const simCycle_t simCycles[] =
+{
+    SIM_CYCLE("winter",  -5.0, 1800.0, simWinter),
+    SIM_CYCLE("summer",  45.0, 1800.0, simSummer),
+    SIM_CYCLE("steps",   18.0, 3600.0, simSteps),
+    SIM_CYCLE("weather",  5.0, 3600.0, simWeather),
+};
+
+
+/* metrics of one segment (from an event to the next one) */
+typedef struct
+{
+    double tStart;
+    double tSettle;             /* last time outside the band */
+    double overshoot;           /* max excursion past the set temperature (*C) */
+    double energy;              /* J at segment start */
+    double dir;                 /* +1 heating towards set, -1 cooling */
+    unsigned int transitions;
+    unsigned char setTemp;
+} simSeg_t;
+
+unsigned char simVerbose = 0;
+
+
+
+/*******************************************************************************
+ * LCD/UART of the host build: nothing to drive
+ */
+void LcdInit(void) { }
+void LcdClear(void) { }
+void LcdGoTo(char pos) { (void)pos; }
+void LcdChar(unsigned char letter) { (void)letter; }
+void LcdWriteString(const char *s) { (void)s; }
+void LcdLoadGlyphs(unsigned char code, const unsigned char *rows, unsigned char n) { (void)code; (void)rows; (void)n; }
+char *LcdBar(char *dst, unsigned char cols, unsigned char cells) { (void)cols; (void)cells; *dst = '\0'; return dst; }
+unsigned char LcdCell(char pos, unsigned char letter) { (void)pos; (void)letter; return 1; }
+void LcdShift(void) { }
+void LcdHome(void) { }
+void McpInInit(mcp_t *m, unsigned char mask) { (void)m; (void)mask; }
+void McpInIsr(mcp_t *m) { (void)m; }
+unsigned char McpInTick(mcp_t *m) { (void)m; return 0; }
+mcp_t lcdMcp;
+void SpiBusInit(void) { }
+unsigned char SpiBusTask(void) { return 0; }
+void LogInit(void) { }
+void LogAdd(const unsigned char *rec) { (void)rec; }
+void LogTask(void) { }
+void LogDump(void) { }
+unsigned char SettingsLoad(unsigned char *data) { (void)data; return 0; }
+void SettingsTick(const unsigned char *data) { (void)data; }
+void SettingsTask(void) { }
+
+char UART_Init(void) { return 1; }
+void UART_putc(char data) { (void)data; }
+void UART_puts(char *s) { if (simVerbose > 1) fputs(s, stdout); }
+char UART_Data_Ready(void) { return 0; }
+char UART_Read(void) { return 0; }
+
+
+
+/*******************************************************************************
+ * Actuators Function
+ *  - what pwm.c and updateOutputs() put on the pins => model inputs
+ */
+void simActuators(void)
+{
+    unsigned long counts;
+
+    counts = ((unsigned int)CCPR1L << 2) | CCP1CONbits.DC1B;
+    ThermalSetFanCool((unsigned int)(counts * PWM_DUTY_MAX / PWM_FAN_COUNTS));
+
+    counts = ((unsigned int)CCPR2L << 2) | CCP2CONbits.DC2B;
+    ThermalSetFanHeatVent((unsigned int)(counts * PWM_DUTY_MAX / PWM_FAN_COUNTS));
+
+    ThermalSetHeat(pwmHeatDuty);
+    ThermalSetCool(PORTDbits.RD1);  /* cool element */
+} /* void simActuators(void) */
+
+
+
+/*******************************************************************************
+ * Segment Report Function
+ */
+void simReport(const simSeg_t *seg, double tEnd)
+{
+    double settle = seg->tSettle - seg->tStart;
+
+    printf("  %6.0fs  set %2u*C  ", seg->tStart, seg->setTemp);
+    if (seg->tSettle >= tEnd - SIM_DT)
+        printf("settling   ---   ");
+    else
+        printf("settling %5.0fs  ", settle);
+    printf("overshoot %4.1f*C  energy %6.1fWh  transitions %u\n",
+           seg->overshoot,
+           (ThermalEnergy() - seg->energy) / 3600.0,
+           seg->transitions);
+} /* void simReport(const simSeg_t *seg, double tEnd) */
+
+
+
+/*******************************************************************************
+ * Segment Start Function
+ */
+void simSegStart(simSeg_t *seg, double t, unsigned char setTemp)
+{
+    seg->tStart = t;
+    seg->tSettle = t;
+    seg->overshoot = 0.0;
+    seg->energy = ThermalEnergy();
+    seg->dir = (setTemp > ThermalTemp()) ? 1.0 : -1.0;
+    seg->transitions = 0;
+    seg->setTemp = setTemp;
+} /* void simSegStart(simSeg_t *seg, double t, unsigned char setTemp) */
+
+
+
+/*******************************************************************************
+ * Run Cycle Function
+ */
+void simRun(const simCycle_t *cyc)
+{
+    simSeg_t seg;
+    unsigned char ev = 0;
+    unsigned char i;
+    unsigned char rb0 = 1;
+    unsigned char setTemp = SIM_TEMP_MIN;
+    unsigned char state;
+    double t = 0.0;
+    double err;
+    double trace = 0.0;
+    unsigned int total = 0;
+
+    ThermalInit(cyc->tIn, cyc->events[0].tOut);
+    ThermalSetPot(0);
+    PORTBbits.RB0 = 1;      /* button released */
+    init();
+    state = climaFsm.state;
+
+    printf("%s: cabin %.0f*C, outside %.0f*C\n", cyc->name, cyc->tIn, cyc->events[0].tOut);
+    simSegStart(&seg, 0.0, setTemp);
+
+    while (t < cyc->duration)
+    {
+        PORTBbits.RB0 = 1;
+        while ((ev < cyc->nEvents) && (cyc->events[ev].t <= t))
+        {
+            if (cyc->events[ev].setTemp)
+            {
+                if (t > 0.0)
+                    simReport(&seg, t);
+                setTemp = cyc->events[ev].setTemp;
+                /* pot in the middle of the 64 codes of this temperature */
+                ThermalSetPot((setTemp - SIM_TEMP_MIN) * 64 + 32);
+                simSegStart(&seg, t, setTemp);
+            }
+            ThermalSetOutside(cyc->events[ev].tOut);
+            if (cyc->events[ev].button)
+                PORTBbits.RB0 = 0;  /* pressed for one cycle */
+            ev++;
+        }
+
+        /* INT0 on the programmed edge of RB0 */
+        if ((PORTBbits.RB0 != rb0) && (PORTBbits.RB0 == INTEDG0))
+            INT0IF = 1;
+        rb0 = PORTBbits.RB0;
+
+        for (i = 0; i < SIM_TICKS; i++)
+        {
+            T0IF = 1;
+            ISR();
+        }
+        climaCycle();
+        if (climaFsm.state != state)
+        {
+            state = climaFsm.state;
+            seg.transitions++;
+            total++;
+        }
+        simActuators();
+        ThermalStep(SIM_DT);
+        t += SIM_DT;
+
+        /* settling and overshoot against the set temperature */
+        err = ThermalTemp() - setTemp;
+        if ((err > SIM_BAND) || (err < -SIM_BAND))
+            seg.tSettle = t;
+        if (err * seg.dir > seg.overshoot)
+            seg.overshoot = err * seg.dir;
+
+        if (simVerbose && (t >= trace))
+        {
+            printf("    %6.0fs  Tin %5.1f  state %u  heat %3u%%  fanC %3u%%  fanHV %3u%%  cool %u\n",
+                   t, ThermalTemp(), climaFsm.state,
+                   pwmHeatDuty * 100 / PWM_DUTY_MAX,
+                   CCPR1L * 100 / (unsigned int)(PWM_FAN_PR2 + 1),
+                   CCPR2L * 100 / (unsigned int)(PWM_FAN_PR2 + 1),
+                   PORTDbits.RD1);
+            trace += SIM_TRACE;
+        }
+    }
+    simReport(&seg, t);
+    printf("  total: energy %.1fWh, %u state transitions\n\n", ThermalEnergy() / 3600.0, total);
+} /* void simRun(const simCycle_t *cyc) */
+
+
+
+int main(int argc, char *argv[])
+{
+    unsigned char i;
+
+    if ((argc > 1) && (strcmp(argv[1], "-v") == 0))
+        simVerbose = 1;
+
+    for (i = 0; i < sizeof(simCycles) / sizeof(simCycles[0]); i++)
+        simRun(&simCycles[i]);
+
+    return 0;
+}
+
@@ -0,0 +1,240 @@
+/*
+ * File:   eelogtest.c
+ * Author: Dragos
+ *
+ * Created on October 20, 2026, 4:10 AM
+ *
+ * host check of eelog.c and spibus.c against an emulated 25LC256: the
+ * instructions READ, WRITE, WREN and RDSR on the bytes SWSPIWrite() gets
+ * while RA3 is low; a page write is done at the end of its frame and WIP
+ * stays 1 for EE_BUSY_POLLS status reads, as the 5ms write cycle
+ *
+ *   blank  - LogInit() on a blank chip starts at page 0
+ *   boot   - 20 pages, then LogInit() again goes on at page 20, boot 1
+ *   wrap   - 600 pages more, the ring wrapped, LogInit() finds the head
+ *   dump   - LogDump() sends the 512 pages, the oldest first
+ *
+ * build and run on the PC, from the project directory:
+ *   gcc -DCLIMA_SIM -Isim -I. sim/eelogtest.c eelog.c spibus.c fmt.c bcd.c -o eelogtest
+ *   ./eelogtest
+ */
+
+#define SIM_REGS_DEFINE
+#include <p18f8722.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "spibus.h"
+#include "eelog.h"
+#include "swspi.h"
+#include "uart.h"
+
+
+/* 25LC256 instructions, as eelog.c */
+#define EE_READ         0x03
+#define EE_WRITE        0x02
+#define EE_WREN         0x06
+#define EE_RDSR         0x05
+
+#define EE_SIZE         32768
+#define EE_BUSY_POLLS   3       /* RDSR answers with WIP = 1 after a write */
+#define EE_CS           (1<<3)  /* RA3 */
+
+/* eelog.c, spibus.c */
+extern unsigned char spiRun[];
+extern unsigned int logHead, logUsed, logSeq, logLost;
+extern unsigned char logBoot, logDumping;
+
+unsigned char ee[EE_SIZE];
+int eeFrame = -1;               /* spiRun[SPI_DEV_EEPROM] of the frame, -1 none */
+unsigned char eeInstr;
+unsigned char eePos;            /* byte of the frame */
+unsigned int eeAddr;
+unsigned char eeWel = 0;
+unsigned char eeBusy = 0;       /* RDSR polls left of the write cycle */
+unsigned char eePage[LOG_PAGE_SIZE];
+unsigned char eeLen = 0;        /* bytes of the WRITE frame */
+unsigned int eeWrites = 0;
+
+unsigned char out[EE_SIZE + 64];    /* bytes sent by UART_Send() */
+unsigned int outLen = 0;
+
+int fails = 0;
+
+
+
+/*******************************************************************************
+ * End Frame Function
+ *  - CS went high: the bytes of a WRITE are written, WEL is cleared
+ */
+void eeEnd(void)
+{
+    unsigned char i;
+
+    if ((eeInstr == EE_WRITE) && eeLen)
+    {
+        /* the address wraps in the page, as on the chip */
+        for (i = 0; i < eeLen; i++)
+            ee[(eeAddr & ~(LOG_PAGE_SIZE - 1)) | ((eeAddr + i) & (LOG_PAGE_SIZE - 1))] = eePage[i];
+        eeWel = 0;
+        eeBusy = EE_BUSY_POLLS;
+        eeWrites++;
+    }
+    eeInstr = 0;
+    eeLen = 0;
+} /* void eeEnd(void) */
+
+
+
+void SWSPIOpen(void)
+{
+}
+
+/* spiRun[] goes up after each frame: a new value is a new frame */
+char SWSPIWrite(char output)
+{
+    unsigned char v = (unsigned char)output;
+    unsigned char in = 0xFF;
+
+    if (LATA & EE_CS)
+        return in;  /* the MCP23S17 frames */
+
+    if (eeFrame != spiRun[SPI_DEV_EEPROM])
+    {
+        eeEnd();
+        eeFrame = spiRun[SPI_DEV_EEPROM];
+        eePos = 0;
+    }
+
+    if (eePos == 0)
+    {
+        eeInstr = v;
+        if ((v == EE_WREN) && !eeBusy)
+            eeWel = 1;
+    }
+    else if (eeInstr == EE_RDSR)
+    {
+        in = eeBusy ? 1 : 0;
+        if (eeBusy)
+            eeBusy--;
+    }
+    else if (eePos == 1)
+        eeAddr = (unsigned int)v << 8;
+    else if (eePos == 2)
+        eeAddr |= v;
+    else if (eeInstr == EE_READ)
+        in = ee[(eeAddr + eePos - 3) & (EE_SIZE - 1)];
+    else if ((eeInstr == EE_WRITE) && eeWel && !eeBusy && (eeLen < LOG_PAGE_SIZE))
+        eePage[eeLen++] = v;
+
+    eePos++;
+    return (char)in;
+} /* char SWSPIWrite(char output) */
+
+
+char UART_Tx_Ready(void)
+{
+    return 1;
+}
+
+void UART_Send(char data)
+{
+    out[outLen++] = (unsigned char)data;
+}
+
+void UART_puts(char *s)
+{
+    printf("%s", s + 2);    /* without "\n\r" */
+}
+
+
+
+/*******************************************************************************
+ * Pages Function
+ *  - n pages of records, the log tasks run between two records
+ */
+void addPages(unsigned int n)
+{
+    unsigned char rec[LOG_REC_SIZE];
+    unsigned int r;
+    unsigned char i;
+
+    for (r = 0; r < n * LOG_PAGE_RECS; r++)
+    {
+        memset(rec, r & 0xFF, sizeof(rec));
+        LogAdd(rec);
+        for (i = 0; i < 20; i++)
+        {
+            SpiBusTask();
+            LogTask();
+        }
+    }
+    SpiBusTask();
+    eeEnd();    /* the frame of the last page */
+} /* void addPages(unsigned int n) */
+
+
+/*******************************************************************************
+ * Boot Function
+ *  - a power cycle: the RAM of the log is lost, the EEPROM is not
+ */
+void boot(void)
+{
+    SpiBusInit();
+    eeFrame = -1;   /* spiRun[] starts again from 0 */
+    LogInit();
+} /* void boot(void) */
+
+
+void check(const char *name, unsigned int head, unsigned int used,
+           unsigned int seq, unsigned char bootCnt)
+{
+    int ok = (logHead == head) && (logUsed == used) && (logSeq == seq) && (logBoot == bootCnt);
+
+    printf("%-6s head %3u used %3u seq %3u boot %u  %s\n",
+           name, logHead, logUsed, logSeq, logBoot, ok ? "ok" : "FAIL");
+    if (!ok)
+        fails++;
+} /* void check(...) */
+
+
+int main(void)
+{
+    unsigned int first;
+    unsigned int last;
+
+    memset(ee, 0xFF, sizeof(ee));
+
+    boot();
+    check("blank", 0, 0, 0, 0);
+
+    addPages(20);
+    boot();
+    check("boot", 20, 20, 20, 1);
+
+    addPages(600);
+    boot();
+    check("wrap", 620 % LOG_PAGES, LOG_PAGES, 620, 2);
+
+    LogDump();
+    while (logDumping)
+    {
+        SpiBusTask();
+        LogTask();
+    }
+    first = last = 0;
+    if (outLen >= LOG_PAGE_SIZE)
+    {
+        first = out[2] | (out[3] << 8);
+        last = out[outLen - LOG_PAGE_SIZE + 2] | (out[outLen - LOG_PAGE_SIZE + 3] << 8);
+    }
+    printf("dump   %u bytes, seq %u..%u  %s\n", outLen, first, last,
+           ((outLen == EE_SIZE) && (first == 620 - LOG_PAGES) && (last == 619)) ? "ok" : "FAIL");
+    if ((outLen != EE_SIZE) || (first != 620 - LOG_PAGES) || (last != 619))
+        fails++;
+
+    printf("writes %u, lost %u records\n", eeWrites, logLost);
+
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,173 @@
+/*
+ * File:   fmttest.c
+ * Author: Dragos
+ *
+ * Created on October 20, 2026, 5:50 AM
+ *
+ * host check and benchmark of fmt.c: the text of each function is compared
+ * with the one of snprintf(), then the formatter and sprintf() are timed
+ *
+ *   FmtUint    - 0..65535, width 0..6, "%*u" and "%0*u"
+ *   FmtInt     - -32768..32767, width 0..6, "%*d" and "%0*d"
+ *   FmtHex     - 0..65535, 1..4 digits, "%0*X" of the last digits
+ *   FmtFix1    - -32768..32767, width 0..6, "%d.%d" padded with spaces
+ *
+ * each returned pointer must be on the '\0'
+ *
+ * only the ratios of the times mean something, the PC runs both much faster
+ * than the PIC18, where sprintf() also parses the format with the ___lwdiv
+ * divisions; the real cycles are read on the board with PROF_EN = 1
+ *
+ * build and run on the PC, from the project directory:
+ *   gcc -O2 -I. sim/fmttest.c fmt.c bcd.c -o fmttest
+ *   ./fmttest
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "fmt.h"
+
+
+#define BENCH_ROUNDS    20      /* passes over the 65536 values */
+#define FMT_WIDTH_MAX   6       /* 5 digits + sign */
+
+
+volatile unsigned char benchSink;   /* the compiler must not drop the work */
+
+char got[16];
+char want[32];
+unsigned long bad = 0;
+
+
+
+/*******************************************************************************
+ * Compare Function
+ *  - the text at got, ending at end, must be the one in want; the first
+ *    wrong ones are printed
+ */
+void same(const char *end)
+{
+    if ((strcmp(got, want) == 0) && (end == got + strlen(got)))
+        return;
+
+    if (++bad <= 5)
+        printf("  \"%s\" != \"%s\"\n", got, want);
+} /* void same(const char *end) */
+
+
+/*******************************************************************************
+ * Check Function
+ *  - returns the number of wrong texts
+ */
+unsigned long fmtCheck(void)
+{
+    unsigned long v;
+    unsigned char w;
+    unsigned int u;
+    int s;
+    char *end;
+    char fix[16];
+
+    for (v = 0; v < 65536; v++)
+    {
+        u = (unsigned int)v;
+        s = (short)v;
+
+        for (w = 0; w <= FMT_WIDTH_MAX; w++)
+        {
+            end = FmtUint(got, u, w, ' ');
+            snprintf(want, sizeof(want), "%*u", w, u);
+            same(end);
+
+            end = FmtUint(got, u, w, '0');
+            snprintf(want, sizeof(want), "%0*u", w, u);
+            same(end);
+
+            end = FmtInt(got, s, w, ' ');
+            snprintf(want, sizeof(want), "%*d", w, s);
+            same(end);
+
+            end = FmtInt(got, s, w, '0');
+            snprintf(want, sizeof(want), "%0*d", w, s);
+            same(end);
+
+            end = FmtFix1(got, s, w);
+            snprintf(fix, sizeof(fix), "%s%u.%u", (s < 0) ? "-" : "",
+                     (unsigned int)(s < 0 ? -s : s) / 10, (unsigned int)(s < 0 ? -s : s) % 10);
+            snprintf(want, sizeof(want), "%*s", w, fix);
+            same(end);
+
+            if ((w >= 1) && (w <= 4))
+            {
+                end = FmtHex(got, u, w);
+                snprintf(want, sizeof(want), "%0*X", w, u & (0xFFFFu >> ((4 - w) * 4)));
+                same(end);
+            }
+        }
+    }
+
+    return bad;
+} /* unsigned long fmtCheck(void) */
+
+
+/*******************************************************************************
+ * Time Functions
+ *  - ns per text, "%5u" and the temperature "%d.%d" of the LCD
+ */
+double timeUint(int useFmt)
+{
+    clock_t start;
+    unsigned long v;
+    unsigned int round;
+
+    start = clock();
+    for (round = 0; round < BENCH_ROUNDS; round++)
+    {
+        for (v = 0; v < 65536; v++)
+        {
+            if (useFmt)
+                FmtUint(got, (unsigned int)v, 5, ' ');
+            else
+                sprintf(got, "%5u", (unsigned int)v);
+            benchSink = got[4];
+        }
+    }
+
+    return (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / (BENCH_ROUNDS * 65536.0);
+} /* double timeUint(int useFmt) */
+
+double timeFix1(int useFmt)
+{
+    clock_t start;
+    long v;
+    unsigned int round;
+
+    start = clock();
+    for (round = 0; round < BENCH_ROUNDS; round++)
+    {
+        for (v = -32768; v < 32768; v++)
+        {
+            if (useFmt)
+                FmtFix1(got, (int)v, 0);
+            else
+                sprintf(got, "%d.%d", (int)v / 10, (int)(v < 0 ? -v : v) % 10);
+            benchSink = got[1];
+        }
+    }
+
+    return (double)(clock() - start) * 1e9 / CLOCKS_PER_SEC / (BENCH_ROUNDS * 65536.0);
+} /* double timeFix1(int useFmt) */
+
+
+int main(void)
+{
+    fmtCheck();
+
+    printf("check: %lu wrong texts (Uint, Int, Fix1 width 0..6, Hex 1..4 digits)\n", bad);
+    printf("%%5u     sprintf: %6.2f ns  FmtUint: %6.2f ns\n", timeUint(0), timeUint(1));
+    printf("%%d.%%d   sprintf: %6.2f ns  FmtFix1: %6.2f ns\n", timeFix1(0), timeFix1(1));
+
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,232 @@
+/*
+ * File:   p18f8722.h
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 5:15 PM
+ */
+
+#ifndef P18F8722_SIM_H
+#define	P18F8722_SIM_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/* host build only (CLIMA_SIM), replaces the XC8 device header
+ * the SFRs used by clima.c and pwm.c are plain variables, climasim.c defines them
+ * (SIM_REGS_DEFINE) and reads/writes the pins the real board would drive;
+ * eelogtest.c, settingstest.c and ticktest.c do the same for spibus.c,
+ * settings.c and the tick.c of the demos
+ */
+
+#ifdef SIM_REGS_DEFINE
+#define SIM_REG
+#else
+#define SIM_REG extern
+#endif
+
+#define interrupt   /* the ISR is a plain function on the host */
+
+typedef struct
+{
+    unsigned CCPM       :4;
+    unsigned DCB        :2;
+} CCPxCONbits_t;
+
+typedef struct
+{
+    unsigned T2CKPS     :2;
+    unsigned TMR2ON     :1;
+    unsigned T2OUTPS    :4;
+} T2CONbits_t;
+
+typedef struct
+{
+    unsigned TMR1ON     :1;
+    unsigned TMR1CS     :1;
+    unsigned T1SYNC     :1;
+    unsigned T1OSCEN    :1;
+    unsigned T1CKPS     :2;
+    unsigned T1RUN      :1;
+    unsigned RD16       :1;
+} T1CONbits_t;
+
+typedef struct
+{
+    unsigned TRISC0:1, TRISC1:1, TRISC2:1, TRISC3:1, TRISC4:1, TRISC5:1, TRISC6:1, TRISC7:1;
+} TRISCbits_t;
+
+typedef struct
+{
+    unsigned TRISG0:1, TRISG1:1, TRISG2:1, TRISG3:1, TRISG4:1;
+} TRISGbits_t;
+
+typedef struct
+{
+    unsigned LATG0:1, LATG1:1, LATG2:1, LATG3:1, LATG4:1;
+} LATGbits_t;
+
+typedef struct
+{
+    unsigned ADON       :1;
+    unsigned GO_nDONE   :1;
+    unsigned CHS        :4;
+} ADCON0bits_t;
+
+typedef struct
+{
+    unsigned PCFG       :4;
+    unsigned VCFG       :2;
+} ADCON1bits_t;
+
+typedef struct
+{
+    unsigned ADCS       :3;
+    unsigned ACQT       :3;
+    unsigned            :1;
+    unsigned ADFM       :1;
+} ADCON2bits_t;
+
+typedef struct
+{
+    unsigned T0PS       :3;
+    unsigned PSA        :1;
+    unsigned T0SE       :1;
+    unsigned T0CS       :1;
+    unsigned T08BIT     :1;
+    unsigned TMR0ON     :1;
+} T0CONbits_t;
+
+typedef struct
+{
+    unsigned            :7;
+    unsigned EBDIS      :1;
+} MEMCONbits_t;
+
+typedef struct
+{
+    unsigned char RB0:1, RB1:1, RB2:1, RB3:1, RB4:1, RB5:1, RB6:1, RB7:1;
+} PORTBbits_t;              /* one byte, same storage as PORTB */
+
+typedef struct
+{
+    unsigned RD0:1, RD1:1, RD2:1, RD3:1, RD4:1, RD5:1, RD6:1, RD7:1;
+} PORTDbits_t;
+
+typedef struct
+{
+    unsigned TRISD0:1, TRISD1:1, TRISD2:1, TRISD3:1, TRISD4:1, TRISD5:1, TRISD6:1, TRISD7:1;
+} TRISDbits_t;
+
+typedef struct
+{
+    unsigned RJ0:1, RJ1:1, RJ2:1, RJ3:1, RJ4:1, RJ5:1, RJ6:1, RJ7:1;
+} PORTJbits_t;
+
+typedef struct
+{
+    unsigned TRISJ0:1, TRISJ1:1, TRISJ2:1, TRISJ3:1, TRISJ4:1, TRISJ5:1, TRISJ6:1, TRISJ7:1;
+} TRISJbits_t;
+
+SIM_REG volatile unsigned char ADCON0, ADCON1, ADCON2;
+SIM_REG volatile ADCON0bits_t ADCON0bits;
+SIM_REG volatile ADCON1bits_t ADCON1bits;
+SIM_REG volatile ADCON2bits_t ADCON2bits;
+SIM_REG volatile unsigned int ADRES;
+
+SIM_REG volatile unsigned char T0CON;
+SIM_REG volatile T0CONbits_t T0CONbits;
+SIM_REG volatile unsigned int TMR0;
+SIM_REG volatile unsigned char TMR0H, TMR0L, TMR1H, TMR1L;
+SIM_REG volatile unsigned char T0IE, T0IF, GIE;
+SIM_REG volatile unsigned char INT0IE, INT0IF, INTEDG0, INT1IE, INT1IF, INTEDG1, RBIE, RBIF;
+
+SIM_REG volatile MEMCONbits_t MEMCONbits;
+
+SIM_REG volatile unsigned char PORTB;
+#define PORTBbits   (*(volatile PORTBbits_t *)&PORTB)
+SIM_REG volatile unsigned char TRISB, TRISB0;
+SIM_REG volatile unsigned char TRISA;
+SIM_REG volatile unsigned char PORTD, TRISD;
+SIM_REG volatile PORTDbits_t PORTDbits;
+SIM_REG volatile TRISDbits_t TRISDbits;
+SIM_REG volatile PORTJbits_t PORTJbits;
+SIM_REG volatile TRISJbits_t TRISJbits;
+
+
+/* pwm.c: CCP1/CCP2 PWM on TMR2, CCP3 compare on TMR1 */
+#define DC1B    DCB
+#define DC2B    DCB
+SIM_REG volatile unsigned char CCP1CON, CCP2CON, CCP3CON;
+SIM_REG volatile CCPxCONbits_t CCP1CONbits, CCP2CONbits;
+SIM_REG volatile unsigned char CCPR1L, CCPR2L;
+SIM_REG volatile unsigned int CCPR3;
+SIM_REG volatile unsigned char PR2, T2CON, T1CON;
+SIM_REG volatile T2CONbits_t T2CONbits;
+SIM_REG volatile T1CONbits_t T1CONbits;
+SIM_REG volatile unsigned char TMR1IF, TMR1IE, PEIE;
+
+/* TMR2 does not run on the host: each access finds the PWM period elapsed,
+ * so the wait of PwmInit() ends
+ */
+SIM_REG volatile unsigned char simTmr2If;
+static inline volatile unsigned char *simTmr2IfSet(void)
+{
+    simTmr2If = 1;
+    return &simTmr2If;
+}
+#define TMR2IF  (*simTmr2IfSet())
+SIM_REG volatile TRISCbits_t TRISCbits;
+SIM_REG volatile TRISGbits_t TRISGbits;
+SIM_REG volatile LATGbits_t LATGbits;
+
+
+/* spibus.c: chip selects on RA2 (MCP23S17), RA3 (25LC256) */
+typedef struct
+{
+    unsigned TRISA0:1, TRISA1:1, TRISA2:1, TRISA3:1, TRISA4:1, TRISA5:1;
+} TRISAbits_t;
+
+SIM_REG volatile unsigned char LATA;
+SIM_REG volatile TRISAbits_t TRISAbits;
+
+
+/* tick.c of the demos: TMR4 1ms interrupt */
+typedef struct
+{
+    unsigned T4CKPS     :2;
+    unsigned TMR4ON     :1;
+    unsigned T4OUTPS    :4;
+} T4CONbits_t;
+
+SIM_REG volatile unsigned char T4CON, TMR4, PR4, TMR4IF, TMR4IE;
+SIM_REG volatile T4CONbits_t T4CONbits;
+
+
+/* settings.c: data EEPROM, EEDATA is the byte of EEADRH:EEADR in simEe[];
+ * the write cycle ends when the host program clears EECON1bits.WR
+ */
+typedef struct
+{
+    unsigned RD:1, WR:1, WREN:1, WRERR:1, FREE:1, :1, CFGS:1, EEPGD:1;
+} EECON1bits_t;
+
+SIM_REG volatile unsigned char EEADR, EEADRH, EECON2;
+SIM_REG volatile EECON1bits_t EECON1bits;
+SIM_REG volatile unsigned char simEe[1024];
+SIM_REG unsigned long simEeAccess;      /* EEDATA reads and writes */
+static inline volatile unsigned char *simEeData(void)
+{
+    simEeAccess++;
+    return &simEe[((EEADRH << 8) | EEADR) & 1023];
+}
+#define EEDATA  (*simEeData())
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* P18F8722_SIM_H */
+
@@ -0,0 +1,198 @@
+/*
+ * File:   settingstest.c
+ * Author: Dragos
+ *
+ * Created on October 20, 2026, 4:40 AM
+ *
+ * host check of settings.c on the data EEPROM of sim/p18f8722.h (simEe[]),
+ * a byte write cycle ends at the next SettingsTask() call
+ *
+ *   blank  - SettingsLoad() on an erased EEPROM returns 0
+ *   knob   - 10 changes one second apart, then the hold: one slot written
+ *   ring   - 300 saves, past the 128 slots, the last one is loaded
+ *   torn   - a save cut after 3 bytes: its sequence is the newest, its CRC
+ *            bad, the slot before it is loaded
+ *   torn1  - a save cut after the low byte of the sequence
+ *   after  - the next save takes the cut slot
+ *   wrap   - a full ring across the 16 bit wrap of the sequence
+ *
+ * a load with a good newest slot reads the sequences and that slot only
+ * (TEST_LOAD_READS bytes), a cut one the slot before it too
+ *
+ * build and run on the PC, from the project directory:
+ *   gcc -DCLIMA_SIM -Isim -I. sim/settingstest.c settings.c -o settingstest
+ *   ./settingstest
+ */
+
+#define SIM_REGS_DEFINE
+#include <p18f8722.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "settings.h"
+
+
+#define TEST_TASKS      20      /* SettingsTask() calls in one second */
+
+#define TEST_LOAD_READS (2 * SETTINGS_SLOTS + SETTINGS_SLOT)  /* sequences, newest slot */
+
+/* settings.c */
+extern unsigned char stgPos;
+extern unsigned char stgHold;
+extern unsigned int stgSeq;
+
+unsigned int writes = 0;        /* EEPROM bytes written */
+unsigned long loadReads;        /* EEPROM bytes read by the last SettingsLoad() */
+int fails = 0;
+
+
+
+/*******************************************************************************
+ * Second Function
+ *  - SettingsTick() with data, then the main loop for one second
+ */
+void second(const unsigned char *data)
+{
+    unsigned char i;
+
+    SettingsTick(data);
+    for (i = 0; i < TEST_TASKS; i++)
+    {
+        if (EECON1bits.WR)
+        {
+            EECON1bits.WR = 0;  /* the write cycle is over */
+            writes++;
+        }
+        SettingsTask();
+    }
+} /* void second(const unsigned char *data) */
+
+
+void check(const char *name, int ok)
+{
+    printf("%-6s %s\n", name, ok ? "ok" : "FAIL");
+    if (!ok)
+        fails++;
+} /* void check(const char *name, int ok) */
+
+
+/*******************************************************************************
+ * Boot Function
+ *  - a power cycle: the RAM of settings.c is lost, SettingsLoad() in got;
+ *    loadReads - the EEPROM bytes it read
+ */
+unsigned char boot(unsigned char *got)
+{
+    unsigned char found;
+
+    stgPos = SETTINGS_SLOT;
+    stgHold = 0;
+    memset(got, 0, SETTINGS_SIZE);
+    simEeAccess = 0;
+    found = SettingsLoad(got);
+    loadReads = simEeAccess;
+
+    return found;
+} /* unsigned char boot(unsigned char *got) */
+
+
+/*******************************************************************************
+ * Save Function
+ *  - data held SETTINGS_HOLD_TIME, one slot written
+ */
+void save(const unsigned char *data)
+{
+    unsigned char i;
+
+    for (i = 0; i < SETTINGS_HOLD_TIME + 1; i++)
+        second(data);
+} /* void save(const unsigned char *data) */
+
+
+/*******************************************************************************
+ * Cut Function
+ *  - a save of data, the power goes off after n bytes of the slot
+ */
+void cut(const unsigned char *data, unsigned char n)
+{
+    unsigned char i;
+
+    for (i = 0; i < SETTINGS_HOLD_TIME + 1; i++)
+        SettingsTick(data);
+    for (i = 0; i < n; i++)
+    {
+        SettingsTask();
+        EECON1bits.WR = 0;
+    }
+} /* void cut(const unsigned char *data, unsigned char n) */
+
+
+int main(void)
+{
+    unsigned char set[SETTINGS_SIZE] = { 21, 0, 0, 0, 0 };
+    unsigned char got[SETTINGS_SIZE];
+    unsigned char found;
+    unsigned int n;
+    unsigned char t;
+
+    memset((void *)simEe, 0xFF, sizeof(simEe));
+
+    found = boot(got);
+    printf("       %lu bytes read\n", loadReads);
+    check("blank", found == 0);
+
+    for (t = 21; t <= 30; t++)
+    {
+        set[0] = t;
+        second(set);
+    }
+    save(set);
+    found = boot(got);
+    printf("       %u bytes written, set %u, %lu bytes read\n", writes, got[0], loadReads);
+    check("knob", found && (writes == SETTINGS_SLOT) && (got[0] == 30)
+          && (loadReads == TEST_LOAD_READS));
+
+    for (n = 0; n < 300; n++)
+    {
+        set[0] = n & 0x7F;
+        set[2] = 1;
+        save(set);
+    }
+    found = boot(got);
+    printf("       %u bytes written, set %u on %u, %lu bytes read\n", writes, got[0], got[2], loadReads);
+    check("ring", found && (writes == 301 * SETTINGS_SLOT) && (got[0] == (299 & 0x7F)) && (got[2] == 1)
+          && (loadReads == TEST_LOAD_READS));
+
+    /* power off after the sequence and one byte: the newest sequence, bad CRC */
+    set[0] = 77;
+    cut(set, 3);
+    found = boot(got);
+    printf("       set %u, %lu bytes read\n", got[0], loadReads);
+    check("torn", found && (got[0] == (299 & 0x7F))
+          && (loadReads == TEST_LOAD_READS + SETTINGS_SLOT));
+
+    /* power off after the low byte of the sequence only */
+    cut(set, 1);
+    found = boot(got);
+    check("torn1", found && (got[0] == (299 & 0x7F)));
+
+    /* the next save goes to the cut slot */
+    save(set);
+    found = boot(got);
+    check("after", found && (got[0] == 77) && (loadReads == TEST_LOAD_READS));
+
+    /* a full ring across the 16 bit wrap of the sequence */
+    stgSeq = 0xFFC0;
+    for (n = 0; n < SETTINGS_SLOTS; n++)
+    {
+        set[0] = n & 0x7F;
+        set[1] = n >> 7;
+        save(set);
+    }
+    found = boot(got);
+    printf("       set %u, next sequence %04X\n", got[0], stgSeq);
+    check("wrap", found && (got[0] == 127) && (stgSeq == 0x0040));
+
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * File:   thermal.c
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 5:15 PM
+ */
+
+#include "thermal.h"
+
+
+static double tIn;          /* cabin air (*C) */
+static double tCore;        /* heater core (*C) */
+static double tOut;         /* outside (*C) */
+static double heat;         /* heat element duty 0..1 */
+static double fanCool;      /* cool FAN duty 0..1 */
+static double fanHeatVent;  /* heat/vent FAN duty 0..1 */
+static unsigned char cool;  /* compressor ON */
+static double energy;       /* electric energy since init (J) */
+static unsigned int pot;    /* AN0 code */
+
+
+
+/*******************************************************************************
+ * Voltage to ADC code Function
+ *  - 10 bit, 5V reference, clamped like the real converter
+ */
+static unsigned int thermalCode(double mV)
+{
+    double code = mV * 1023.0 / 5000.0 + 0.5;
+
+    if (code < 0.0)
+        return 0;
+    if (code > 1023.0)
+        return 1023;
+
+    return (unsigned int)code;
+} /* static unsigned int thermalCode(double mV) */
+
+
+
+/*******************************************************************************
+ * Init Function
+ *  - the car was parked long enough, the heater core is at cabin temperature
+ */
+void ThermalInit(double in, double out)
+{
+    tIn = in;
+    tCore = in;
+    tOut = out;
+    heat = 0.0;
+    fanCool = 0.0;
+    fanHeatVent = 0.0;
+    cool = 0;
+    energy = 0.0;
+    pot = 0;
+} /* void ThermalInit(double in, double out) */
+
+
+
+/*******************************************************************************
+ * Inputs
+ *  - duties are the 10 bit values given to the PWM layer
+ */
+void ThermalSetOutside(double out)
+{
+    tOut = out;
+}
+
+void ThermalSetPot(unsigned int adc)
+{
+    pot = adc;
+}
+
+void ThermalSetHeat(unsigned int duty)
+{
+    heat = duty / 1023.0;
+}
+
+void ThermalSetFanCool(unsigned int duty)
+{
+    fanCool = duty / 1023.0;
+}
+
+void ThermalSetFanHeatVent(unsigned int duty)
+{
+    fanHeatVent = duty / 1023.0;
+}
+
+void ThermalSetCool(unsigned char on)
+{
+    cool = on;
+}
+
+
+
+/*******************************************************************************
+ * Step Function
+ *  - explicit Euler, dt well below the core time constant (~13s at FAN 100%)
+ */
+void ThermalStep(double dt)
+{
+    double gh = THERMAL_GH_MIN + THERMAL_GH_FAN * fanHeatVent;
+    double gv = THERMAL_GV_FAN * fanHeatVent;
+    double pHeat = THERMAL_P_HEAT * (heat > 1.0 ? 1.0 : heat);
+    double qCore = gh * (tCore - tIn);
+    double qCool = 0.0;
+    double pElec = pHeat + THERMAL_P_FAN * (fanCool + fanHeatVent);
+
+    if (cool)
+    {
+        qCool = THERMAL_Q_COOL * fanCool;
+        pElec += THERMAL_P_COMP;
+    }
+
+    tCore += dt * (pHeat - qCore) / THERMAL_CH;
+    tIn += dt * (THERMAL_UA * (tOut - tIn) + qCore + gv * (tOut - tIn) - qCool) / THERMAL_C;
+    energy += dt * pElec;
+} /* void ThermalStep(double dt) */
+
+
+
+/*******************************************************************************
+ * ADC Function
+ *  - what ADCRead() returns on the real board
+ */
+unsigned int ThermalAdc(unsigned char ch)
+{
+    switch (ch)
+    {
+        case 0:
+            return pot;
+        case 1:
+            return thermalCode(400.0 + 19.5 * tOut);
+        case 3:
+            return thermalCode(10.0 * tIn);
+        default:
+            return 0;
+    }
+} /* unsigned int ThermalAdc(unsigned char ch) */
+
+
+
+/*******************************************************************************
+ * Outputs
+ */
+double ThermalTemp(void)
+{
+    return tIn;
+}
+
+double ThermalEnergy(void)
+{
+    return energy;
+}
+
@@ -0,0 +1,62 @@
+/*
+ * File:   thermal.h
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 5:15 PM
+ */
+
+#ifndef THERMAL_H
+#define	THERMAL_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/* lumped thermal model of the cabin, host only (double, no PIC code)
+ *
+ *   cabin:       C  * dTin/dt  = UA*(Tout - Tin) + Gh*(Th - Tin)
+ *                                + Gv*(Tout - Tin) - Qcool
+ *   heater core: Ch * dTh/dt   = Pheat - Gh*(Th - Tin)
+ *
+ * Gh grows with the heat/vent FAN air flow, Gv is the fresh air brought by
+ * the same FAN, Qcool is the evaporator power moved by the cool FAN
+ * (compressor ON/OFF = cool element output)
+ *
+ * the sensors are returned as the ADC codes clima.c converts:
+ *   AN1 MCP9701 (outside): 400mV + 19.5mV per *C
+ *   AN3 LM35    (inside) :   0mV + 10mV per *C
+ *   AN0 potentiometer    : set by ThermalSetPot()
+ */
+
+#define THERMAL_C           (60000.0)   /* cabin heat capacity (J/K) */
+#define THERMAL_UA          (40.0)      /* cabin to outside (W/K) */
+#define THERMAL_CH          (2000.0)    /* heater core heat capacity (J/K) */
+#define THERMAL_GH_MIN      (5.0)       /* core to cabin, FAN OFF (W/K) */
+#define THERMAL_GH_FAN      (150.0)     /* core to cabin, FAN 100% (W/K) */
+#define THERMAL_GV_FAN      (20.0)      /* fresh air, FAN 100% (W/K) */
+#define THERMAL_P_HEAT      (2000.0)    /* heat element at 100% (W) */
+#define THERMAL_Q_COOL      (2500.0)    /* evaporator, cool FAN 100% (W) */
+#define THERMAL_P_COMP      (1000.0)    /* compressor electric power (W) */
+#define THERMAL_P_FAN       (150.0)     /* each FAN at 100% (W) */
+
+
+void ThermalInit(double tIn, double tOut);
+void ThermalSetOutside(double tOut);
+void ThermalSetPot(unsigned int adc);
+void ThermalSetHeat(unsigned int duty);
+void ThermalSetFanCool(unsigned int duty);
+void ThermalSetFanHeatVent(unsigned int duty);
+void ThermalSetCool(unsigned char on);
+void ThermalStep(double dt);
+unsigned int ThermalAdc(unsigned char ch);
+double ThermalTemp(void);
+double ThermalEnergy(void);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* THERMAL_H */
+
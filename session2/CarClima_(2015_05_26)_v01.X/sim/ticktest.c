@@ -0,0 +1,188 @@
+/*
+ * File:   ticktest.c
+ * Author: Dragos
+ *
+ * Created on October 20, 2026, 5:20 AM
+ *
+ * host check of the tick.c of the demos (the four copies are the same file)
+ * against wall-clock time: TMR4 is run from the T4CON/PR4 that TickInit()
+ * writes, in instruction cycles (Tcy 0.4us), and TickIsr() is called on each
+ * match the postscaler lets through, as the real ISR
+ *
+ *   tmr4   - the TMR4 setup gives a 1ms interrupt (2500 Tcy)
+ *   every  - TickEvery() with the periods of the demos, the main loop late
+ *            by up to TEST_LOOP_MAX Tcy, across the 16 bit wrap of the tick:
+ *            every period is there, none drifts
+ *   10s    - TickElapsed() of the StateMachine STATE 2, across the wrap
+ *
+ * build and run on the PC, from the project directory:
+ *   gcc -DCLIMA_SIM -Isim -I../DigtalOutputs1 sim/ticktest.c ../DigtalOutputs1/tick.c -o ticktest
+ *   ./ticktest
+ */
+
+#define SIM_REGS_DEFINE
+#include <p18f8722.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "tick.h"
+
+
+#define TEST_TCY_PER_MS     2500UL      /* 10MHz/4 */
+#define TEST_RUN_MS         70000UL     /* more than the 65536ms of the wrap */
+#define TEST_WRAP_IN        500         /* ms from the start to the wrap */
+#define TEST_LOOP_MIN       50          /* main loop cycle (Tcy) */
+#define TEST_LOOP_MAX       3000        /* 1.2ms, a late call */
+
+/* tick.c */
+extern volatile tick_t tickCount;
+
+const unsigned char tmr4Presc[4] = { 1, 4, 16, 16 };   /* T4CKPS */
+
+unsigned long tcy = 0;          /* wall-clock, instruction cycles */
+unsigned long tmr4Tcy;          /* Tcy of one TMR4 count, from the prescaler */
+unsigned long tmr4Next;         /* tcy of the next TMR4 count */
+unsigned char tmr4Post = 0;     /* postscaler counter */
+unsigned long isrs = 0;
+
+int fails = 0;
+
+
+
+/*******************************************************************************
+ * Run Function
+ *  - the wall-clock goes on by n Tcy, TMR4 with it; the interrupt is taken
+ *    when TickGet() has not masked it
+ */
+void run(unsigned long n)
+{
+    unsigned long end = tcy + n;
+
+    tmr4Tcy = tmr4Presc[T4CONbits.T4CKPS];
+    while (tmr4Next <= end)
+    {
+        tcy = tmr4Next;
+        tmr4Next += tmr4Tcy;
+        if (!T4CONbits.TMR4ON)
+            continue;
+
+        if (TMR4 != PR4)
+        {
+            TMR4++;
+            continue;
+        }
+        TMR4 = 0;   /* match: reset, one postscaler count */
+        if (++tmr4Post <= T4CONbits.T4OUTPS)
+            continue;
+        tmr4Post = 0;
+        TMR4IF = 1;
+        if (GIE && PEIE && TMR4IE)
+        {
+            TickIsr();
+            isrs++;
+        }
+    }
+    tcy = end;
+} /* void run(unsigned long n) */
+
+
+/*******************************************************************************
+ * Loop Function
+ *  - one main loop cycle of random length
+ */
+void loop(void)
+{
+    run(TEST_LOOP_MIN + rand() % (TEST_LOOP_MAX - TEST_LOOP_MIN));
+} /* void loop(void) */
+
+
+void check(int ok)
+{
+    if (!ok)
+        fails++;
+    printf("  %s\n", ok ? "ok" : "FAIL");
+} /* void check(int ok) */
+
+
+/*******************************************************************************
+ * Every Function
+ *  - TickEvery(ms) for TEST_RUN_MS: the n-th period must come n*ms after the
+ *    start, one tick early at most (the first tick was partly gone) and one
+ *    tick plus one loop cycle late at most
+ */
+void every(tick_t ms)
+{
+    tick_t last;
+    unsigned long start;
+    unsigned long n = 0;
+    long off;
+    long offMin = 0;
+    long offMax = 0;
+
+    tickCount = (tick_t)(0 - TEST_WRAP_IN);
+    last = TickGet();
+    start = tcy;
+
+    while (tcy - start < TEST_RUN_MS * TEST_TCY_PER_MS)
+    {
+        loop();
+        if (!TickEvery(&last, TICK_MS(ms)))
+            continue;
+
+        n++;
+        off = (long)(tcy - start) - (long)(n * ms * TEST_TCY_PER_MS);
+        if (off < offMin)
+            offMin = off;
+        if (off > offMax)
+            offMax = off;
+    }
+
+    printf("every  %5ums: %6lu periods in %lus, off %+5.2f..%+5.2fms",
+           ms, n, TEST_RUN_MS / 1000,
+           offMin / (double)TEST_TCY_PER_MS, offMax / (double)TEST_TCY_PER_MS);
+    check((n >= TEST_RUN_MS / ms - 1) && (n <= TEST_RUN_MS / ms)
+          && (offMin >= -(long)TEST_TCY_PER_MS)
+          && (offMax <= (long)(TEST_TCY_PER_MS + TEST_LOOP_MAX)));
+} /* void every(tick_t ms) */
+
+
+int main(void)
+{
+    static const tick_t periods[] =
+    {
+        1000, 100, 200,     /* DigtalOutputs1 sequences */
+        10,                 /* PWM LedControl() ramp */
+        40                  /* AnalogInputs sequence1 */
+    };
+    unsigned long period;
+    unsigned long start;
+    unsigned long wall;
+    tick_t since;
+    unsigned char i;
+
+    srand(1);
+    TickInit();
+    tmr4Next = 0;
+
+    /* one TickIsr() each 1ms: 10 in 10ms */
+    run(10 * TEST_TCY_PER_MS + 1);
+    period = tmr4Presc[T4CONbits.T4CKPS] * (PR4 + 1UL) * (T4CONbits.T4OUTPS + 1UL);
+    printf("tmr4   %lu Tcy per interrupt, %lu in 10ms", period, isrs);
+    check((period == TEST_TCY_PER_MS) && (isrs == 10));
+
+    for (i = 0; i < sizeof(periods) / sizeof(periods[0]); i++)
+        every(periods[i]);
+
+    /* StateMachine: STATE 2 for 10s, the wrap 3s after its start */
+    tickCount = (tick_t)(0 - 3000);
+    since = TickGet();
+    start = tcy;
+    while (!TickElapsed(since, TICK_MS(10000)))
+        loop();
+    wall = tcy - start;
+    printf("10s    TickElapsed() after %.2fms", wall / (double)TEST_TCY_PER_MS);
+    check((wall >= 9999 * TEST_TCY_PER_MS) && (wall <= 10001 * TEST_TCY_PER_MS + TEST_LOOP_MAX));
+
+    return fails ? 1 : 0;
+}
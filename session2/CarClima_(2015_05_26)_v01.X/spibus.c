@@ -0,0 +1,215 @@
+/*
+ * File:   spibus.c
+ * Author: Dragos
+ *
+ * Created on October 20, 2026, 12:50 AM
+ */
+
+#include <p18f8722.h>
+
+#include "spibus.h"
+
+#define USE_SW_SPI  1
+#if USE_SW_SPI
+#include "swspi.h"
+#else
+#include <spi.h>
+#endif
+
+
+typedef struct
+{
+    unsigned char hdr[SPI_HDR_MAX];
+    unsigned char hdrLen;
+    const unsigned char *tx;    /* 0 - zeros are sent */
+    unsigned char *rx;          /* 0 - the answer is dropped */
+    unsigned char len;
+} spi_xfer_t;
+
+typedef struct
+{
+    volatile unsigned char *lat;    /* chip select, active low */
+    unsigned char mask;
+} spi_cs_t;
+
+/* same order as SPI_DEV_ */
+const spi_cs_t spiCs[SPI_DEVS] =
+{
+    { &LATA, (1<<2) },      /* SPI_DEV_MCP, RA2 */
+    { &LATA, (1<<3) }       /* SPI_DEV_EEPROM, RA3 */
+};
+
+spi_xfer_t spiQ[SPI_DEVS][SPI_QUEUE_LEN];
+unsigned char spiHead[SPI_DEVS];    /* next transaction to run */
+unsigned char spiCount[SPI_DEVS];   /* transactions queued */
+unsigned char spiIssued[SPI_DEVS];  /* tickets given */
+unsigned char spiRun[SPI_DEVS];     /* transactions done */
+unsigned char spiNext = 0;          /* device served first by the next SpiBusTask() */
+
+
+
+/*******************************************************************************
+ * Byte Function
+ *  - one byte out, one byte in
+ */
+unsigned char spiByte(unsigned char out)
+{
+#if USE_SW_SPI // use SW SPI
+    return SWSPIWrite(out);
+#else // use HW SPI
+    WriteSPI1(out);
+    return SSP1BUF;
+#endif
+} /* unsigned char spiByte(unsigned char out) */
+
+
+
+/*******************************************************************************
+ * Run Function
+ *  - the oldest transaction of dev, CS held for all of it
+ */
+void spiRunOne(unsigned char dev)
+{
+    spi_xfer_t *x = &spiQ[dev][spiHead[dev]];
+    unsigned char i;
+    unsigned char in;
+
+    *spiCs[dev].lat &= ~spiCs[dev].mask;    // CS low, transmission starts
+
+    for (i = 0; i < x->hdrLen; i++)
+        spiByte(x->hdr[i]);
+
+    for (i = 0; i < x->len; i++)
+    {
+        in = spiByte(x->tx ? x->tx[i] : 0x00);
+        if (x->rx)
+            x->rx[i] = in;
+    }
+
+    *spiCs[dev].lat |= spiCs[dev].mask;     // CS high, transmission ends
+
+    if (++spiHead[dev] == SPI_QUEUE_LEN)
+        spiHead[dev] = 0;
+    spiCount[dev]--;
+    spiRun[dev]++;
+} /* void spiRunOne(unsigned char dev) */
+
+
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONs                                                        BEGIN
+ */
+
+
+/*******************************************************************************
+ * Init Function
+ *  - SPI pins, all chip selects high, empty queues
+ */
+void SpiBusInit(void)
+{
+    unsigned char dev;
+
+#if USE_SW_SPI // use SW SPI
+    SWSPIOpen();
+#else // use HW SPI
+    // configure SPI: the MCP23S17 chip's max frequency is 10MHz, let's use 10MHz/64 (Note FOSC=10Mhz, our external oscillator)
+    OpenSPI1(SPI_FOSC_64, MODE_10, SMPEND); // frequency, master-slave mode, sampling type
+#endif
+
+    for (dev = 0; dev < SPI_DEVS; dev++)
+    {
+        *spiCs[dev].lat |= spiCs[dev].mask;
+        spiHead[dev] = 0;
+        spiCount[dev] = 0;
+        spiIssued[dev] = 0;
+        spiRun[dev] = 0;
+    }
+    TRISAbits.TRISA2 = 0;   // chip selects are outputs
+    TRISAbits.TRISA3 = 0;
+} /* void SpiBusInit(void) */
+
+
+/*******************************************************************************
+ * Queue Function
+ *  - returns the ticket of the transaction, see SpiDone()
+ *  - a full queue is emptied by one transaction first, the only case the
+ *    caller waits
+ */
+unsigned char SpiQueue(unsigned char dev, const unsigned char *hdr, unsigned char hdrLen,
+                       const unsigned char *tx, unsigned char *rx, unsigned char len)
+{
+    spi_xfer_t *x;
+    unsigned char i;
+
+    if (spiCount[dev] == SPI_QUEUE_LEN)
+        spiRunOne(dev);
+
+    i = spiHead[dev] + spiCount[dev];
+    if (i >= SPI_QUEUE_LEN)
+        i -= SPI_QUEUE_LEN;
+    x = &spiQ[dev][i];
+
+    for (i = 0; i < hdrLen; i++)
+        x->hdr[i] = hdr[i];
+    x->hdrLen = hdrLen;
+    x->tx = tx;
+    x->rx = rx;
+    x->len = len;
+
+    spiCount[dev]++;
+    return ++spiIssued[dev];
+} /* unsigned char SpiQueue(...) */
+
+
+/*******************************************************************************
+ * Done Function
+ *  - 1 when the transaction of ticket has run, the 8 bit counters wrap
+ */
+unsigned char SpiDone(unsigned char dev, unsigned char ticket)
+{
+    return (signed char)(spiRun[dev] - ticket) >= 0;
+} /* unsigned char SpiDone(unsigned char dev, unsigned char ticket) */
+
+
+/*******************************************************************************
+ * Bus Task Function
+ *  - one transaction, the devices in turn
+ *  - returns 0 when nothing was queued
+ */
+unsigned char SpiBusTask(void)
+{
+    unsigned char n;
+    unsigned char dev = spiNext;
+
+    for (n = 0; n < SPI_DEVS; n++)
+    {
+        if (++spiNext == SPI_DEVS)
+            spiNext = 0;
+
+        if (spiCount[dev])
+        {
+            spiRunOne(dev);
+            return 1;
+        }
+        dev = spiNext;
+    }
+
+    return 0;
+} /* unsigned char SpiBusTask(void) */
+
+
+/*******************************************************************************
+ * Sync Function
+ *  - the queue of dev is run to the end, the others wait
+ */
+void SpiSync(unsigned char dev)
+{
+    while (spiCount[dev])
+        spiRunOne(dev);
+} /* void SpiSync(unsigned char dev) */
+
+
+
+/*******************************************************************************
+ * PUBLIC FUNCTIONs                                                          END
+ */
@@ -0,0 +1,57 @@
+/*
+ * File:   spibus.h
+ * Author: Dragos
+ *
+ * Created on October 20, 2026, 12:50 AM
+ */
+
+#ifndef SPIBUS_H
+#define	SPIBUS_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/* SPI bus of the explorer board, SCK RC3, SDI RC4, SDO RC5 (see swspi.h),
+ * one chip select per device
+ *
+ *   SPI_DEV_MCP      RA2   MCP23S17 expanders, up to 8 on the same CS, told
+ *                          apart by A2..A0 in the opcode (IOCON.HAEN)
+ *   SPI_DEV_EEPROM   RA3   25LC256
+ *
+ * a transaction is CS low, hdrLen header bytes (opcode, address, ...), len
+ * data bytes from tx (0x00 if tx is 0) with the answer stored in rx (if rx
+ * is not 0), CS high
+ *
+ * SpiQueue() copies the header, tx and rx are used later and have to stay
+ * valid; each device has its own queue, SpiBusTask() runs one transaction
+ * per call taking the devices in turn, so a long EEPROM page and the LCD
+ * frames are interleaved; the main loop calls it while it waits
+ *
+ * the ticket returned by SpiQueue() tells when a transaction is done
+ * (SpiDone()), SpiSync() runs the bus until a device has nothing queued,
+ * for the reads that are needed at once
+ */
+
+#define SPI_DEV_MCP         0
+#define SPI_DEV_EEPROM      1
+#define SPI_DEVS            2
+
+#define SPI_QUEUE_LEN       16      /* transactions per device */
+#define SPI_HDR_MAX         4       /* header bytes copied in the queue */
+
+void SpiBusInit(void);
+unsigned char SpiQueue(unsigned char dev, const unsigned char *hdr, unsigned char hdrLen,
+                       const unsigned char *tx, unsigned char *rx, unsigned char len);
+unsigned char SpiDone(unsigned char dev, unsigned char ticket);
+unsigned char SpiBusTask(void);
+void SpiSync(unsigned char dev);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* SPIBUS_H */
+
@@ -42,7 +42,7 @@ char UART_Init(void)
     SPBRG = x;              // Writing SPBRG register
     TXSTAbits.TXEN =1;      // Enables Transmissio
     RCSTAbits.CREN =1;      // Enables Continuous Reception
-    PIE1bits.RCIE = 1;
+    PIE1bits.RCIE = 0;      // reception is polled with UART_Data_Ready()
     RCSTA1bits.SPEN = 1;    // Enables Serial Port
 
     return 0;
@@ -69,6 +69,18 @@ char UART_Read()
 } /* char UART_Read() */
 
 
+char UART_Tx_Ready()
+{
+  return TXIF;              // TXREG is free, UART_Send() does not wait
+} /* char UART_Tx_Ready() */
+
+
+void UART_Send(char data)
+{
+  TXREG = data;             // only after UART_Tx_Ready(), back to back at the full baud rate
+} /* void UART_Send(char data) */
+
+
 void UART_Read_Text(char *Output, unsigned int length)
 {
   int i;
@@ -14,7 +14,12 @@ extern "C" {
 
 
 char UART_Init(void);
+void UART_putc(char data);
 void UART_puts(char *s);
+char UART_Data_Ready(void);
+char UART_Read(void);
+char UART_Tx_Ready(void);
+void UART_Send(char data);
 
 #ifdef	__cplusplus
 }
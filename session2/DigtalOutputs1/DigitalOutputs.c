@@ -14,6 +14,7 @@
 #include <p18f8722.h>
 
 #include "DigitalOutputs.h"
+#include "tick.h"
 
 
 // configuration bits
@@ -47,6 +48,9 @@ void init(void)
 
     initLEDs();
 
+    /* init 1ms system tick */
+    TickInit();
+
 } /* void init(void) */
 
 
@@ -63,128 +67,51 @@ void setLED(byte nrLED, unsigned state)
     }
 } /* void setLED(byte nrLED, unsigned state) */
 
+/* step time of the sequences (ms) */
+#define SEQ1_STEP   (1000)
+#define SEQ2_STEP   (100)
+#define SEQ3_STEP   (200)
+
+/* patterns of sequence2, one per step */
+const byte seq2Pattern[16] =
+{
+    0b00000001, 0b00000010, 0b00000100, 0b00001000,
+    0b00010000, 0b00100000, 0b01000000, 0b10000000,
+    0b10000000, 0b01000000, 0b00100000, 0b00010000,
+    0b00001000, 0b00000100, 0b00000010, 0b00000001
+};
+
 void sequence1(void)
 {
     /* sequence start */
+    static tick_t seqTime = 0;
+    static byte step = 0;
 
-    //put your code here
-    
-        for (int i=0; i<50; i++)
-        {
-            _delay(50000);
-        }
-        LATD = 0b00111100;
+    /* nothing to do until the step time passed */
+    if (!TickEvery(&seqTime, TICK_MS(SEQ1_STEP)))
+        return;
 
-        for (int i=0; i<50; i++)
-        {
-               _delay(50000);
-        }
+    if (step == 0)
+        LATD = 0b00111100;
+    else
         LATD = 0b11000011;
-    
-    
-    
-    
+    step = !step;
+
     /* sequence end */
 }
 
 void sequence2(void)
 {
     /* sequence start */
+    static tick_t seqTime = 0;
+    static byte step = 0;
 
-    //put your code here
-        for (int i=0; i<50; i++)
-        {
-            _delay(5000);
-        }
-        LATD = 0b00000001;
+    if (!TickEvery(&seqTime, TICK_MS(SEQ2_STEP)))
+        return;
 
-        for (int i=0; i<50; i++)
-        {
-               _delay(5000);
-        }
-        LATD = 0b00000010;
-        for (int i=0; i<50; i++)
-        {
-            _delay(5000);
-        }
-        LATD = 0b00000100;
-
-        for (int i=0; i<50; i++)
-        {
-               _delay(5000);
-        }
-        LATD = 0b00001000;
-        for (int i=0; i<50; i++)
-        {
-            _delay(5000);
-        }
-        LATD = 0b00010000;
+    LATD = seq2Pattern[step];
+    step = (step + 1) & 0x0F;
 
-        for (int i=0; i<50; i++)
-        {
-               _delay(5000);
-        }
-        LATD = 0b00100000;
-        for (int i=0; i<50; i++)
-        {
-            _delay(5000);
-        }
-        LATD = 0b01000000;
-
-        for (int i=0; i<50; i++)
-        {
-               _delay(5000);
-        }
-        LATD = 0b10000000;
-        
-        
-        
-         for (int i=0; i<50; i++)
-        {
-            _delay(5000);
-        }
-        LATD = 0b10000000;
-
-        for (int i=0; i<50; i++)
-        {
-               _delay(5000);
-        }
-        LATD = 0b01000000;
-        for (int i=0; i<50; i++)
-        {
-            _delay(5000);
-        }
-        LATD = 0b00100000;
-
-        for (int i=0; i<50; i++)
-        {
-               _delay(5000);
-        }
-        LATD = 0b00010000;
-        for (int i=0; i<50; i++)
-        {
-            _delay(5000);
-        }
-        LATD = 0b00001000;
-
-        for (int i=0; i<50; i++)
-        {
-               _delay(5000);
-        }
-        LATD = 0b00000100;
-        for (int i=0; i<50; i++)
-        {
-            _delay(5000);
-        }
-        LATD = 0b00000010;
-
-        for (int i=0; i<50; i++)
-        {
-               _delay(5000);
-        }
-        LATD = 0b00000001;
-        
-        
     /* sequence end */
 }
 
@@ -207,13 +134,11 @@ void sequence2(void)
 //    } varianta 2 nu merge bine
 //}
     void sequence2v3(void){
-        int i;
+        static tick_t seqTime = 0;
         static int state = 0;
         static int operation = 1;
-        for (i=0; i<50; i++)
-        {
-            _delay(5000);
-        }
+        if (!TickEvery(&seqTime, TICK_MS(2*SEQ2_STEP)))
+            return;
         LATD = 1 << state ;
         state += operation;
         if (state >= 8)
@@ -221,48 +146,51 @@ void sequence2(void)
         else
             if(state == 0)
                 operation = 1;
-    
-        for (i=0; i<50; i++)
-        {
-            _delay(5000);
-        }
     //codul lor , e bun  // face 100 010 001 010 100
     }
     
 void sequence3(void)
 {// face 1000 0100 0010 0001 1001 0101 0011
     /* sequence start */
-
-    //put your code here
-        int i;
+        static tick_t seqTime = 0;
+        static byte lit = 0;    /* 1 - the moving LED is shown */
         int static limit = 7;
         static int state = 0;
         static int value = 0;
-        for (i=0; i<50; i++)
-        {
-            _delay(10000);
+        if (!TickEvery(&seqTime, TICK_MS(SEQ3_STEP)))
+            return;
+        if (!lit)
+        {
+            LATD = value | 1 << state ;
+            state ++;
+            if (state > limit){
+                value = value | 1 << limit;
+                limit--;
+                state = 0;
+            }
+            if(value == 0XFF){
+                value = 0;
+                limit = 7;
+            }
         }
-        LATD = value | 1 << state ;
-        state ++;
-        if (state > limit){
-            value = value | 1 << limit;
-            limit--;
-            state = 0;
-        }
-        if(value == 0XFF){
-            value = 0;
-            limit = 7;
-        }
-        for (i=0; i<50; i++)
+        else
         {
-            _delay(10000);
+            LATD = value;
         }
-        LATD = value
-    
+        lit = !lit;
     
     /* sequence end */
 }
 
+/*******************************************************************************
+ * Interrupt Service Routine (keyword "interrupt" tells the compiler it's an ISR)
+ */
+void interrupt ISR(void)
+{
+    /* 1ms system tick */
+    TickIsr();
+} /* void interrupt ISR(void) */
+
 /*******************************************************************************
  * Main Function
  */
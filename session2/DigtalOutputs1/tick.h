@@ -0,0 +1,45 @@
+/*
+ * File:   tick.h
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 11:05 AM
+ */
+
+#ifndef TICK_H
+#define	TICK_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/* system tick
+ * TMR4 generates an interrupt each 1ms, the ISR counts it in a free running
+ * 16 bit counter, so an interval can be measured up to 65535ms
+ *
+ * busy waits like _delay()/Delay10KTCYx() are replaced by:
+ *
+ *     static tick_t last;
+ *     if (TickEvery(&last, 100))   // true once each 100ms, never blocks
+ *     {
+ *         ...
+ *     }
+ */
+typedef unsigned int tick_t;
+
+#define TICK_MS(ms)     ((tick_t)(ms))  /* 1 tick = 1ms */
+
+
+void TickInit(void);
+void TickIsr(void);
+tick_t TickGet(void);
+unsigned char TickElapsed(tick_t since, tick_t ms);
+unsigned char TickEvery(tick_t *last, tick_t ms);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* TICK_H */
+
@@ -16,6 +16,7 @@
 #include <delays.h>
 #include "LCD.h"
 #include "DigitalInputs.h"
+#include "debounce.h"
 
 
 // configuration bits
@@ -29,6 +30,15 @@
 #define RIGHTBUTTON PORTAbits.RA4 
 /* END OF TODO: Write your port here */
 
+/* butoanele filtrate (debounce) in intreruperea TMR0 la 4ms,
+ * DEB_SAMPLES * 4ms = 16ms, un bit pe buton
+ */
+#define BTN_LEFT        (1<<0)  // RB0
+#define BTN_RIGHT       (1<<4)  // RA4
+
+deb_t buttonsA;
+deb_t buttonsB;
+
 
 
 /*******************************************************************************
@@ -42,10 +52,54 @@ void initButtons(void)
     /* RA4 butonul drept */
     TRISA4 = 1; /* configurare RA4 ca input */
 
+    /* starea initiala a butoanelor, apasat = 1 */
+    DebInit(&buttonsB, ~PORTB & BTN_LEFT);
+    DebInit(&buttonsA, ~PORTA & BTN_RIGHT);
+
 } /* void initButtons(void) */
 
 
 
+/*******************************************************************************
+ * Init Timer Function
+ */
+void initTmr(void)
+{
+// START - TMR0 setup
+    T0CON = 0;
+    T0CONbits.T08BIT = 0;   // 16bit timer
+    T0CONbits.T0CS = 0;     // internal source clock
+    T0CONbits.PSA = 0;      // prescaler active
+    T0CONbits.T0PS = 1;     // prescaler 1:4 => timer clock = (10MHz/4) / 4 = 625Khz
+    /* 625Khz * 4ms = 2500 => 65536 - 2500 = 63036 = F63Cx */
+    TMR0H = 0xF6;
+    TMR0L = 0x3C;
+    T0IE = 1;               // enable TMR0 overflow interrupts
+    GIE = 1;                // enable Global interrupts
+    T0CONbits.TMR0ON = 1;   // timer ON
+// END - TMR0 setup
+} /* void initTmr(void) */
+
+
+
+/*******************************************************************************
+ *  Interrupt Service Routine - esantionare butoane la 4ms
+ */
+void interrupt ISR(void)
+{
+    if (T0IE && T0IF)
+    {
+        T0IF = 0;
+        TMR0H = 0xF6;           // reload counter for 4ms interrupt
+        TMR0L = 0x3C;
+
+        DebSample(&buttonsB, ~PORTB & BTN_LEFT);
+        DebSample(&buttonsA, ~PORTA & BTN_RIGHT);
+    }
+}
+
+
+
 
 
 /*******************************************************************************
@@ -112,43 +166,28 @@ void sequence2(void)
 /* void sequence2(void) */
 
 void sequence3(void)
+{
+    static int buttonTimesPressed = 0;
+    char message_P[32];
 
-{   
-    char leftButton = LEFTBUTTON;
-    //static int buttonTimesPressed = 0;
-    static int temporaryCounter = 0;
-    static char lastState = 0;
-    
-    char message_P[32]="Pressed    ";
-    
-    if (0 == leftButton
-        && lastState =! leftButton){
-        
-            lastState = leftButton;
-            temporaryCounter++;
-            _delay(10000);
-            if(temporaryCounter == 5){
-                LcdGoTo(0);
-                LcdWriteString(message_P);
-            }
-            
-        }else{
-            temporaryCounter = 0;
-        }  
-        // mai voiau sa aprindem si led pentru a repr numarul de click-uri 
-        //i++ ul se mareste si daca tii butonul apasat, 
-        //alta cerinta era sa se contorizeze 3 click-uri si sa se intample ceva
-     
- 
-        
-
-        /*Afisare pe ecran starea butonului - Not pressed*/
-
-    // daca butonul se apasa o perioada de timp , atunci s-a inregistrat actiunea
-  /* TODO: 
-  *Implementarea SW Debounce pentru butonul stang RB0
-  * END OF TODO */
+    /* SW Debounce: apasarile butonului stang vin filtrate din intrerupere,
+     * fara _delay() si fara a bloca bucla principala
+     */
+    if (DebPressed(&buttonsB, BTN_LEFT))
+    {
+        buttonTimesPressed++;
+        sprintf(message_P, "Pressed %d times", buttonTimesPressed);
+        LcdGoTo(0);
+        LcdWriteString(message_P);
+    }
 
+    /* butonul drept RA4 sterge numaratoarea */
+    if (DebPressed(&buttonsA, BTN_RIGHT))
+    {
+        buttonTimesPressed = 0;
+        LcdGoTo(0);
+        LcdWriteString("Not Pressed     ");
+    }
 }
  
 /* void sequence3(void) */
@@ -168,6 +207,9 @@ void main()
 
   initButtons();
 
+  /* TMR0 la 4ms pentru debounce */
+  initTmr();
+
   /*initializarea LCD-ului - functia este apelata de 3 ori pentru stabilizare*/
 
   LcdInit();
@@ -0,0 +1,86 @@
+/*
+ * File:   debounce.c
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 7:10 PM
+ */
+
+#include <p18f8722.h>
+
+#include "debounce.h"
+
+
+
+/*******************************************************************************
+ * Debounce Init Function
+ *  - the inputs start at their present level, a button held during reset
+ *    gives no press edge
+ */
+void DebInit(deb_t *d, unsigned char raw)
+{
+    d->state = raw;
+    d->cnt0 = 0xFF;         /* counters at 3 */
+    d->cnt1 = 0xFF;
+    d->press = 0;
+    d->release = 0;
+} /* void DebInit(deb_t *d, unsigned char raw) */
+
+
+
+/*******************************************************************************
+ * Debounce Sample Function
+ *  - called from the timer ISR, raw: 1 = pressed
+ */
+void DebSample(deb_t *d, unsigned char raw)
+{
+    unsigned char changed;
+
+    changed = d->state ^ raw;
+
+    /* count down where changed, back to 3 where not */
+    d->cnt0 = ~(d->cnt0 & changed);
+    d->cnt1 = d->cnt0 ^ (d->cnt1 & changed);
+
+    /* counters wrapped 0 -> 3: DEB_SAMPLES changed samples in a row */
+    changed &= d->cnt0 & d->cnt1;
+
+    d->state ^= changed;
+    d->press |= d->state & changed;
+    d->release |= ~d->state & changed;
+} /* void DebSample(deb_t *d, unsigned char raw) */
+
+
+
+/*******************************************************************************
+ * Debounce Pressed Function
+ *  - returns and clears the press edges in mask
+ */
+unsigned char DebPressed(deb_t *d, unsigned char mask)
+{
+    unsigned char edges;
+
+    GIE = 0;                /* the ISR sets new edges */
+    edges = d->press & mask;
+    d->press ^= edges;
+    GIE = 1;
+
+    return edges;
+} /* unsigned char DebPressed(deb_t *d, unsigned char mask) */
+
+
+
+/*******************************************************************************
+ * Debounce Released Function
+ *  - returns and clears the release edges in mask
+ */
+unsigned char DebReleased(deb_t *d, unsigned char mask)
+{
+    unsigned char edges;
+
+    GIE = 0;
+    edges = d->release & mask;
+    d->release ^= edges;
+    GIE = 1;
+
+    return edges;
+} /* unsigned char DebReleased(deb_t *d, unsigned char mask) */
@@ -16,6 +16,8 @@
 //#include <delays.h>
 #include "LCD.h"
 #include "AnalogInputs.h"
+#include "tick.h"
+#include "bcd.h"
 
 
 // configuration bits
@@ -73,10 +75,17 @@ void initAdc(void)
    
  * sequence1 -  Function for displaing the value of the poti to the LATD
  */
+#define SEQ1_PERIOD (40)    /* ms between two conversions in sequence1 */
+
 void sequence1(void)
 {
+    static tick_t seqTime = 0;
     byte potiValue = 0;
-    char reg[100];
+
+    /* the code runs cyclic, sample the poti only each SEQ1_PERIOD */
+    if (!TickEvery(&seqTime, TICK_MS(SEQ1_PERIOD)))
+        return;
+
     /* start conversion*/
     /* -- your code here -- */
     ADCON0bits.GO_DONE = 1;
@@ -90,7 +99,6 @@ void sequence1(void)
     /* read value of the input*/
     /* -- your code here -- */
     LATD = potiValue;
-    Delay10KTCYx(10); //codul ruleaza ciclic, de asta se mai pune un delay ca sa nu fie prea rapid
 
 } /* void sequence1(void) */
 /*******************************************************************************
@@ -116,9 +124,12 @@ void sequence2(void)
     */
     //sau
     char message[16] = "Poti value     ";
-    message[15] = '0'+ potiValue%10;
-    message[14] = '0'+(potiValue/10)%10;
-    message[13] = '0'+ potiValue/100;
+    byte digits[3];
+
+    Bcd8(potiValue, digits); // fara %10, /10, /100 (___awdiv, ___awmod)
+    message[13] = '0' + digits[0];
+    message[14] = '0' + digits[1];
+    message[15] = '0' + digits[2];
     LcdGoTo(0);
     LcdWriteString(message);
     
@@ -165,7 +176,7 @@ void sequence3(void)
     //
     
     //de la ei 
-    potiValue = potiValue/32;
+    potiValue = potiValue >> 5; // /32, shift instead of ___awdiv
     LATD = 1 << potiValue;
     
 } /* void sequence3(void) */
@@ -185,7 +196,7 @@ void sequence4(void)
         ;
     }
     potiValue = ADRESH;
-    potiValue = potiValue/32;
+    potiValue = potiValue >> 5; // /32, shift instead of ___awdiv
     
     for (i = 0; i <= potiValue ; i++){
         ledValue = ledValue + (1 << i);
@@ -198,10 +209,20 @@ void sequence4(void)
     //}
 } /* void sequence4(void) */
 
+/*******************************************************************************
+ * Interrupt Service Routine (keyword "interrupt" tells the compiler it's an ISR)
+ */
+void interrupt ISR(void)
+{
+    /* 1ms system tick */
+    TickIsr();
+} /* void interrupt ISR(void) */
+
 void main()
 {
   
   initButtons();
+  TickInit();
   initAdc();
   LcdInit();
   initLEDs();
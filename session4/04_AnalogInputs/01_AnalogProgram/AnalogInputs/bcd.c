@@ -0,0 +1,74 @@
+/*
+ * File:   bcd.c
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 10:30 PM
+ */
+
+#include "bcd.h"
+
+
+
+/*******************************************************************************
+ * BCD 8 bit Function
+ *  - 0..255 => 3 digits
+ */
+void Bcd8(unsigned char val, unsigned char *digits)
+{
+    unsigned char q;
+
+    q = BCD_DIV100(val);
+    digits[0] = q;
+    val -= q * 100;
+
+    q = BCD_DIV10(val);
+    digits[1] = q;
+    digits[2] = val - q * 10;
+} /* void Bcd8(unsigned char val, unsigned char *digits) */
+
+
+
+/*******************************************************************************
+ * BCD 16 bit Function
+ *  - 0..65535 => 5 digits
+ */
+void Bcd16(unsigned int val, unsigned char *digits)
+{
+    unsigned char lo = (unsigned char)val;
+    unsigned char hi = (unsigned char)(val >> 8);
+    unsigned char n0 = lo & 0x0F;
+    unsigned char n1 = lo >> 4;
+    unsigned char n2 = hi & 0x0F;
+    unsigned char n3 = hi >> 4;
+    unsigned char d0, d1, d2, d3;
+    unsigned char q;
+
+    /* decimal columns, n3 * 6 is added to d0 after its first carry so the
+     * column never passes 255
+     */
+    d0 = n0 + 6 * (n1 + n2);        /* <= 195 */
+    d1 = n1 + 5 * n2 + 9 * n3;      /* <= 225 */
+    d2 = 2 * n2;                    /* <= 30 */
+    d3 = 4 * n3;                    /* <= 60 */
+
+    q = BCD_DIV10(d0);
+    d0 -= q * 10;
+    d1 += q;
+    d0 += 6 * n3;                   /* <= 99 */
+
+    q = BCD_DIV10(d0);
+    digits[4] = d0 - q * 10;
+    d1 += q;                        /* <= 253 */
+
+    q = BCD_DIV10(d1);
+    digits[3] = d1 - q * 10;
+    d2 += q;
+
+    q = BCD_DIV10(d2);
+    digits[2] = d2 - q * 10;
+    d3 += q;
+
+    q = BCD_DIV10(d3);
+    digits[1] = d3 - q * 10;
+    digits[0] = q;
+} /* void Bcd16(unsigned int val, unsigned char *digits) */
@@ -0,0 +1,42 @@
+/*
+ * File:   bcd.h
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 10:30 PM
+ */
+
+#ifndef BCD_H
+#define	BCD_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/* binary to decimal digits without the division routines (___lwdiv, ___lwmod)
+ *
+ * x / 10 for x <= 255 is (x * 205) >> 11 and x / 100 is (x * 41) >> 12, one
+ * 8x8 hardware multiply (MULLW) and a shift of PRODH
+ *
+ * 16 bit: the 4 nibbles are weighted in decimal (Payson)
+ *     n3 * 4096 = n3 * (4*1000 + 0*100 + 9*10 + 6)
+ *     n2 *  256 = n2 * (2*100 + 5*10 + 6)
+ *     n1 *   16 = n1 * (1*10 + 6)
+ * each column stays below 256, then the carries are moved left with BCD_DIV10
+ *
+ * the digits are 0..9, most significant first, '0' + digit for ASCII
+ */
+
+#define BCD_DIV10(x)    ((unsigned char)(((unsigned int)(unsigned char)(x) * 205) >> 11))
+#define BCD_DIV100(x)   ((unsigned char)(((unsigned int)(unsigned char)(x) * 41) >> 12))
+
+void Bcd8(unsigned char val, unsigned char *digits);
+void Bcd16(unsigned int val, unsigned char *digits);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* BCD_H */
+
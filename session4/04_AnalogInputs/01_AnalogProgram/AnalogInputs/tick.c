@@ -0,0 +1,100 @@
+/*
+ * File:   tick.c
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 11:05 AM
+ */
+
+#include <p18f8722.h>
+
+#include "tick.h"
+
+
+volatile tick_t tickCount = 0;  /* counts 1ms periods, free running */
+
+
+
+/*******************************************************************************
+ * Init Tick Function
+ */
+void TickInit(void)
+{
+// START - TMR4 setup
+    /* 1khz => 1ms period
+     * (10MHz/4) / presc 1:4 => timer clock = 625Khz
+     * PR4 = 125 - 1 => 5Khz match
+     * postscaler 1:5 => 1Khz interrupt
+     * the period register reloads the timer in HW, no drift and no reload
+     * correction in the ISR like TMR0 needs
+     */
+    T4CON = 0;
+    T4CONbits.T4CKPS = 0b01;    // prescaler 1:4
+    T4CONbits.T4OUTPS = 0b0100; // postscaler 1:5
+    TMR4 = 0;
+    PR4 = 125 - 1;
+    TMR4IF = 0;
+    TMR4IE = 1;                 // enable TMR4 match interrupts
+    PEIE = 1;                   // enable peripheral interrupts
+    GIE = 1;                    // enable Global interrupts
+    T4CONbits.TMR4ON = 1;       // timer ON
+// END - TMR4 setup
+} /* void TickInit(void) */
+
+
+
+/*******************************************************************************
+ * Tick Interrupt Function
+ *  - call it from the interrupt service routine
+ */
+void TickIsr(void)
+{
+    if (TMR4IE && TMR4IF)
+    {
+        TMR4IF = 0;     // clear interrupt flag
+        tickCount++;    // each 1ms
+    }
+} /* void TickIsr(void) */
+
+
+
+/*******************************************************************************
+ * Get Tick Function
+ */
+tick_t TickGet(void)
+{
+    tick_t now;
+
+    /* 16 bit value, the ISR must not change it between the two bytes */
+    TMR4IE = 0;
+    now = tickCount;
+    TMR4IE = 1;
+
+    return now;
+} /* tick_t TickGet(void) */
+
+
+
+/*******************************************************************************
+ * Elapsed Function
+ *  - returns 1 if at least ms passed since the time stamp
+ */
+unsigned char TickElapsed(tick_t since, tick_t ms)
+{
+    return (tick_t)(TickGet() - since) >= ms;
+} /* unsigned char TickElapsed(tick_t since, tick_t ms) */
+
+
+
+/*******************************************************************************
+ * Periodic Function
+ *  - returns 1 once per ms period, the time stamp is moved by exactly one
+ *    period so a late call does not shift the following ones
+ */
+unsigned char TickEvery(tick_t *last, tick_t ms)
+{
+    if ((tick_t)(TickGet() - *last) < ms)
+        return 0;
+
+    *last += ms;
+    return 1;
+} /* unsigned char TickEvery(tick_t *last, tick_t ms) */
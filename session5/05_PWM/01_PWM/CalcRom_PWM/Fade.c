@@ -0,0 +1,150 @@
+#include "Fade.h"
+#include "Pwm.h"
+#include <xc.h>
+
+typedef struct
+{
+    const uint8 *table;     /* NULL = channel not faded */
+    uint16 phase;
+    uint16 speed;           /* phase increment per step */
+} FadeChan_t;
+
+static FadeChan_t fadeChan[PWM_CHANNELS];
+static volatile uint8 fadeMask = 0;  /* bit n = channel n is faded */
+
+/* linear up/down ramp */
+const uint8 fadeRamp[FADE_TABLE_LEN] =
+{
+      0,   2,   4,   6,   8,  10,  12,  14,  16,  18,  20,  22,  24,  26,  28,  30,
+     32,  34,  36,  38,  40,  42,  44,  46,  48,  50,  52,  54,  56,  58,  60,  62,
+     64,  66,  68,  70,  72,  74,  76,  78,  80,  82,  84,  86,  88,  90,  92,  94,
+     96,  98, 100, 102, 104, 106, 108, 110, 112, 114, 116, 118, 120, 122, 124, 126,
+    128, 129, 131, 133, 135, 137, 139, 141, 143, 145, 147, 149, 151, 153, 155, 157,
+    159, 161, 163, 165, 167, 169, 171, 173, 175, 177, 179, 181, 183, 185, 187, 189,
+    191, 193, 195, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 233, 235, 237, 239, 241, 243, 245, 247, 249, 251, 253,
+    255, 253, 251, 249, 247, 245, 243, 241, 239, 237, 235, 233, 231, 229, 227, 225,
+    223, 221, 219, 217, 215, 213, 211, 209, 207, 205, 203, 201, 199, 197, 195, 193,
+    191, 189, 187, 185, 183, 181, 179, 177, 175, 173, 171, 169, 167, 165, 163, 161,
+    159, 157, 155, 153, 151, 149, 147, 145, 143, 141, 139, 137, 135, 133, 131, 129,
+    128, 126, 124, 122, 120, 118, 116, 114, 112, 110, 108, 106, 104, 102, 100,  98,
+     96,  94,  92,  90,  88,  86,  84,  82,  80,  78,  76,  74,  72,  70,  68,  66,
+     64,  62,  60,  58,  56,  54,  52,  50,  48,  46,  44,  42,  40,  38,  36,  34,
+     32,  30,  28,  26,  24,  22,  20,  18,  16,  14,  12,  10,   8,   6,   4,   2
+};
+
+/* sine breathing, (1 - cos) / 2 */
+const uint8 fadeBreath[FADE_TABLE_LEN] =
+{
+      0,   0,   0,   0,   1,   1,   1,   2,   2,   3,   4,   5,   5,   6,   7,   9,
+     10,  11,  12,  14,  15,  17,  18,  20,  21,  23,  25,  27,  29,  31,  33,  35,
+     37,  40,  42,  44,  47,  49,  52,  54,  57,  59,  62,  65,  67,  70,  73,  76,
+     79,  82,  85,  88,  90,  93,  97, 100, 103, 106, 109, 112, 115, 118, 121, 124,
+    127, 131, 134, 137, 140, 143, 146, 149, 152, 155, 158, 162, 165, 167, 170, 173,
+    176, 179, 182, 185, 188, 190, 193, 196, 198, 201, 203, 206, 208, 211, 213, 215,
+    218, 220, 222, 224, 226, 228, 230, 232, 234, 235, 237, 238, 240, 241, 243, 244,
+    245, 246, 248, 249, 250, 250, 251, 252, 253, 253, 254, 254, 254, 255, 255, 255,
+    255, 255, 255, 255, 254, 254, 254, 253, 253, 252, 251, 250, 250, 249, 248, 246,
+    245, 244, 243, 241, 240, 238, 237, 235, 234, 232, 230, 228, 226, 224, 222, 220,
+    218, 215, 213, 211, 208, 206, 203, 201, 198, 196, 193, 190, 188, 185, 182, 179,
+    176, 173, 170, 167, 165, 162, 158, 155, 152, 149, 146, 143, 140, 137, 134, 131,
+    128, 124, 121, 118, 115, 112, 109, 106, 103, 100,  97,  93,  90,  88,  85,  82,
+     79,  76,  73,  70,  67,  65,  62,  59,  57,  54,  52,  49,  47,  44,  42,  40,
+     37,  35,  33,  31,  29,  27,  25,  23,  21,  20,  18,  17,  15,  14,  12,  11,
+     10,   9,   7,   6,   5,   5,   4,   3,   2,   2,   1,   1,   1,   0,   0,   0
+};
+
+/* red of a HSV color wheel (S = V = 100%), green/blue are 1/3 and 2/3 later */
+const uint8 fadeHue[FADE_TABLE_LEN] =
+{
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 253, 247, 241, 235, 229,
+    223, 217, 211, 205, 199, 193, 187, 181, 175, 169, 163, 157, 151, 145, 139, 133,
+    128, 122, 116, 110, 104,  98,  92,  86,  80,  74,  68,  62,  56,  50,  44,  38,
+     32,  26,  20,  14,   8,   2,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   2,   8,  14,  20,  26,
+     32,  38,  44,  50,  56,  62,  68,  74,  80,  86,  92,  98, 104, 110, 116, 122,
+    128, 133, 139, 145, 151, 157, 163, 169, 175, 181, 187, 193, 199, 205, 211, 217,
+    223, 229, 235, 241, 247, 253, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255
+};
+
+static const uint8 * const fadeWave[FADE_WAVES] = { fadeRamp, fadeBreath, fadeHue };
+
+void FadeInit()
+{
+    uint8 i;
+
+    PIE1bits.TMR2IE = 0;
+    for (i = 0; i < PWM_CHANNELS; i++)
+    {
+        fadeChan[i].table = 0;
+    }
+    fadeMask = 0;
+}
+
+/* start a waveform on one channel, speed from FADE_SPEED_MS(), phase 0..65535 */
+void FadeSet(uint8 chanId, uint8 wave, uint16 speed, uint16 phase)
+{
+    if (chanId >= PWM_CHANNELS || wave >= FADE_WAVES)
+    {
+        return;
+    }
+
+    PIE1bits.TMR2IE = 0;
+    fadeChan[chanId].table = fadeWave[wave];
+    fadeChan[chanId].phase = phase;
+    fadeChan[chanId].speed = speed;
+    fadeMask |= 1 << chanId;
+    PIE1bits.TMR2IE = 1;    // the steps run from the TMR2 interrupt
+}
+
+/* the channel keeps its last duty, setDuty() owns it again */
+void FadeStop(uint8 chanId)
+{
+    if (chanId >= PWM_CHANNELS)
+    {
+        return;
+    }
+
+    PIE1bits.TMR2IE = 0;
+    fadeChan[chanId].table = 0;
+    fadeMask &= ~(1 << chanId);
+    PIE1bits.TMR2IE = 1;    // PwmIsr() turns it off if nothing else is pending
+}
+
+/* color cycle on R, G, B: same table, 120 degrees apart */
+void FadeHsv(uint16 speed)
+{
+    FadeSet(RG0_0, FADE_HUE, speed, 0);
+    FadeSet(RC1_0, FADE_HUE, speed, 43691);     // green 120 degrees after red
+    FadeSet(RC2_0, FADE_HUE, speed, 21845);     // blue 240 degrees after red
+}
+
+uint8 FadeActive()
+{
+    return fadeMask;
+}
+
+/* called by PwmIsr() each FADE_STEP_TCY, returns which duty[] are new */
+uint8 FadeStep(uint8 *duty)
+{
+    uint8 i;
+
+    for (i = 0; i < PWM_CHANNELS; i++)
+    {
+        if (fadeChan[i].table)
+        {
+            duty[i] = fadeChan[i].table[fadeChan[i].phase >> 8];
+            fadeChan[i].phase += fadeChan[i].speed;
+        }
+    }
+
+    return fadeMask;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#ifndef FADE_H
+#define FADE_H
+#include "Types.h"
+#include "PwmCfg.h"
+
+/* waveform player for the PWM channels
+ * each channel reads its own table (256 x 8 bit, in program memory) at its
+ * own phase/speed, PwmIsr() advances all of them FADE_RATE times per second
+ * and writes the new duties at the same PWM edge, main only starts/stops
+ */
+
+#define FADE_RAMP   0   /* linear 0..100..0% */
+#define FADE_BREATH 1   /* sine breathing */
+#define FADE_HUE    2   /* HSV color wheel, see FadeHsv() */
+#define FADE_WAVES  3
+
+#define FADE_TABLE_LEN 256
+
+#define FADE_RATE 100UL     /* duty updates per second */
+#define FADE_STEP_TCY (PWM_FOSC / 4UL / FADE_RATE)  /* Tcy between two updates */
+
+/* speed for one full waveform in ms (phase is 16 bit, table index = phase >> 8) */
+#define FADE_SPEED_MS(ms) ((uint16)((65536UL * (1000UL / FADE_RATE) + (ms) / 2UL) / (ms)))
+
+#if (FADE_STEP_TCY > 60000UL)
+#error "FADE_RATE too low for the 16 bit Tcy accumulator of PwmIsr()"
+#endif
+
+extern void FadeInit();
+extern void FadeSet(uint8 chanId, uint8 wave, uint16 speed, uint16 phase);
+extern void FadeStop(uint8 chanId);
+extern void FadeHsv(uint16 speed);
+extern uint8 FadeActive();
+extern uint8 FadeStep(uint8 *duty);
+
+#endif
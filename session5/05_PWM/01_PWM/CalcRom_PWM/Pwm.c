@@ -2,10 +2,47 @@
 #include "Pwm_Private.h"
 #include <xc.h>
 #include "Adc_1.h"
+#include "Fade.h"
 
 
+static PwmShadow_t pwmShadow;
+static uint16 pwmDuty[PWM_CHANNELS];
+static volatile uint8 pwmCommit = 0;
+static uint8 pwmNextPr2;
+static uint8 pwmNextT2con;
+static uint16 pwmNextTcy;
+static uint16 pwmPeriodTcy;     /* period running now, in Tcy */
+static uint16 pwmFadeTcy = 0;   /* Tcy since the last fade step */
+
+/* gamma 2.2, 8 bit brightness => 10 bit duty, duty = 1023 * (level/255)^2.2 */
+static const uint16 pwmGamma[256] =
+{
+       0,    0,    0,    0,    0,    0,    0,    0,    1,    1,    1,    1,    1,    1,    2,    2,
+       2,    3,    3,    3,    4,    4,    5,    5,    6,    6,    7,    7,    8,    9,    9,   10,
+      11,   11,   12,   13,   14,   15,   16,   16,   17,   18,   19,   20,   21,   23,   24,   25,
+      26,   27,   28,   30,   31,   32,   34,   35,   36,   38,   39,   41,   42,   44,   46,   47,
+      49,   51,   52,   54,   56,   58,   60,   61,   63,   65,   67,   69,   71,   73,   76,   78,
+      80,   82,   84,   87,   89,   91,   94,   96,   98,  101,  103,  106,  109,  111,  114,  117,
+     119,  122,  125,  128,  130,  133,  136,  139,  142,  145,  148,  151,  155,  158,  161,  164,
+     167,  171,  174,  177,  181,  184,  188,  191,  195,  198,  202,  206,  209,  213,  217,  221,
+     225,  228,  232,  236,  240,  244,  248,  252,  257,  261,  265,  269,  274,  278,  282,  287,
+     291,  295,  300,  304,  309,  314,  318,  323,  328,  333,  337,  342,  347,  352,  357,  362,
+     367,  372,  377,  382,  387,  393,  398,  403,  408,  414,  419,  425,  430,  436,  441,  447,
+     452,  458,  464,  470,  475,  481,  487,  493,  499,  505,  511,  517,  523,  529,  535,  542,
+     548,  554,  561,  567,  573,  580,  586,  593,  599,  606,  613,  619,  626,  633,  640,  647,
+     653,  660,  667,  674,  681,  689,  696,  703,  710,  717,  725,  732,  739,  747,  754,  762,
+     769,  777,  784,  792,  800,  807,  815,  823,  831,  839,  847,  855,  863,  871,  879,  887,
+     895,  903,  912,  920,  928,  937,  945,  954,  962,  971,  979,  988,  997, 1005, 1014, 1023
+};
+
+static void pwmCalcDuty(uint8 chanId);
+static uint8 pwmSetCounts(uint32 counts);
+static uint16 pwmCalcTcy(uint8 pr2, uint8 t2con);
+
 void PwmInit()
 {
+    uint8 i;
+
 	TRISCbits.RC2=1;
         TRISCbits.RC1=1;
         TRISGbits.RG0=1;
@@ -18,12 +55,27 @@ void PwmInit()
         CCPR2L=0x00;
         CCPR3L=0x00;
 
-	T2CON=0b00000101;
+    pwmShadow.pr2 = PWM_CFG_PR2(PWM_FREQ_SLOW);
+    pwmShadow.t2con = PWM_CFG_T2CON(PWM_FREQ_SLOW);
+    pwmShadow.tcy = pwmCalcTcy(pwmShadow.pr2, pwmShadow.t2con);
+    pwmPeriodTcy = pwmShadow.tcy;
+    for (i = 0; i < PWM_CHANNELS; i++)
+    {
+        pwmDuty[i] = 0;
+        pwmShadow.ccprl[i] = 0;
+        pwmShadow.dcb[i] = 0;
+    }
+
+	PR2 = pwmShadow.pr2;
+	T2CON = pwmShadow.t2con;
 	while (!PIR1bits.TMR2IF);
 
 	TRISCbits.RC2=0;
         TRISCbits.RC1=0;
         TRISGbits.RG0=0;
+
+    PIR1bits.TMR2IF = 0;
+    INTCONbits.PEIE = 1;
 }
 
 void InteruptInit()
@@ -34,70 +86,252 @@ void InteruptInit()
     INTCON2bits.INTEDG0=1;
 }
 
-void setDuty(uint8 chanId,uint8 duty)
+/* duty in 1/1024 of the current period => 10 bit CCP counts
+ * period = 4*(PR2+1) counts, counts = duty*4*(PR2+1)/1024
+ */
+static void pwmCalcDuty(uint8 chanId)
+{
+    uint16 counts;
+
+    if (pwmDuty[chanId] >= PWM_DUTY_MAX)
+    {
+        counts = 4 * ((uint16)pwmShadow.pr2 + 1); // duty >= period => always high
+        if (counts > 1023)
+            counts = 1023; // PR2 = 0xFF, 10 bits only, 1 count low per period
+    }
+    else
+        counts = (uint16)(((uint32)pwmDuty[chanId] * ((uint16)pwmShadow.pr2 + 1)) >> 8);
+
+    pwmShadow.ccprl[chanId] = counts >> 2;
+    pwmShadow.dcb[chanId] = counts & 0x03;
+}
+
+/* prescaler 1/4/16 from T2CKPS */
+static uint16 pwmCalcTcy(uint8 pr2, uint8 t2con)
+{
+    uint16 tcy = (uint16)pr2 + 1;
+
+    if (t2con & 0x02)
+        tcy <<= 4;
+    else if (t2con & 0x01)
+        tcy <<= 2;
+
+    return tcy;
+}
+
+/* period in Tcy => TMR2 prescaler and PR2, returns 0 if it had to be clamped */
+static uint8 pwmSetCounts(uint32 counts)
+{
+    uint8 ok = 1;
+    uint8 i;
+
+    if (counts < 2)
+    {
+        counts = 2;
+        ok = 0;
+    }
+
+    PIE1bits.TMR2IE = 0;
+    if (counts <= 256)
+    {
+        pwmShadow.t2con = T2CON_ON_PRESC_1;
+        pwmShadow.pr2 = counts - 1;
+    }
+    else if (counts <= 1024)
+    {
+        pwmShadow.t2con = T2CON_ON_PRESC_4;
+        pwmShadow.pr2 = counts / 4 - 1;
+    }
+    else if (counts <= 4096)
+    {
+        pwmShadow.t2con = T2CON_ON_PRESC_16;
+        pwmShadow.pr2 = counts / 16 - 1;
+    }
+    else
+    {
+        pwmShadow.t2con = T2CON_ON_PRESC_16;
+        pwmShadow.pr2 = 0xFF;
+        ok = 0;
+    }
+    pwmShadow.tcy = pwmCalcTcy(pwmShadow.pr2, pwmShadow.t2con);
+
+    /* same duty fraction on the new period */
+    for (i = 0; i < PWM_CHANNELS; i++)
+    {
+        pwmCalcDuty(i);
+    }
+    pwmCommit |= PWM_COMMIT_DUTY | PWM_COMMIT_PERIOD;
+    PIE1bits.TMR2IE = 1;
+
+    return ok;
+}
+
+/* duty 0..1023 (PWM_DUTY_MAX = 100%), applied at the next period edge */
+void setDuty(uint8 chanId,uint16 duty)
 {
-    switch(chanId)
+    if (chanId >= PWM_CHANNELS)
     {
-        case RC2_0:
+        return;
+    }
+    //RC2_0 blue: ledul albastru merge la 70% mereu
+    //RC1_0 G
+    //RG0_0 R
+
+    PIE1bits.TMR2IE = 0;
+    pwmDuty[chanId] = duty;
+    pwmCalcDuty(chanId);
+    pwmCommit |= PWM_COMMIT_DUTY;
+    PIE1bits.TMR2IE = 1;
+}
+
+/* perceived brightness 0..255, the eye sees the steps of setDuty() as even */
+void setBrightness(uint8 chanId, uint8 level)
+{
+    setDuty(chanId, pwmGamma[level]);
+}
+
+/* raw PR2, TMR2 prescaler unchanged */
+void setPeriod(uint8 period)
+{
+    setPeriodReg(period, pwmShadow.t2con);
+}
+
+/* PR2 and T2CON calculated at build time, see PwmCfg.h */
+void setPeriodReg(uint8 pr2, uint8 t2con)
+{
+    uint8 i;
+
+    PIE1bits.TMR2IE = 0;
+    pwmShadow.pr2 = pr2;
+    pwmShadow.t2con = t2con;
+    pwmShadow.tcy = pwmCalcTcy(pr2, t2con);
+    for (i = 0; i < PWM_CHANNELS; i++)
+    {
+        pwmCalcDuty(i);
+    }
+    pwmCommit |= PWM_COMMIT_DUTY | PWM_COMMIT_PERIOD;
+    PIE1bits.TMR2IE = 1;
+}
+
+/* period in us, Tcy = 4/Fosc */
+uint8 setPeriodUs(uint16 us)
+{
+    return pwmSetCounts(((uint32)us * (PWM_FOSC / 1000UL)) / 4000UL);
+}
+
+/* period in Hz */
+uint8 setFrequency(uint16 hz)
+{
+    if (hz == 0)
+    {
+        return 0;
+    }
+    return pwmSetCounts((PWM_FOSC / 4UL) / hz);
+}
+
+/* fade step: 8 bit table value => duty counts without the 32 bit math
+ * of pwmCalcDuty(), 255 => 1020/1024 of the period at PR2 = 0xFF
+ */
+static void pwmFadeDuty(uint8 chanId, uint8 duty8)
+{
+    uint16 counts = ((uint16)duty8 * ((uint16)pwmShadow.pr2 + 1)) >> 6;
+
+    pwmDuty[chanId] = ((uint16)duty8 << 2) | (duty8 >> 6);
+    pwmShadow.ccprl[chanId] = counts >> 2;
+    pwmShadow.dcb[chanId] = counts & 0x03;
+}
+
+/* TMR2 interrupt = start of a PWM period (TMR2 matched PR2 and restarted)
+ * fade:     the elapsed Tcy are summed, each FADE_STEP_TCY the tables give
+ *           new duties for the faded channels, written at this same edge
+ * 1st edge: new CCPRxL/DCxB of all channels, the HW latches them together
+ *           at the next edge
+ * 2nd edge: the duties were just latched, write PR2/T2CON now, so the new
+ *           duties and the new period start with the same PWM period
+ * TMR2IE is only set while something is pending, no cost when idle
+ */
+void PwmIsr()
+{
+    uint8 fadeDuty[PWM_CHANNELS];
+    uint8 fadeNew;
+    uint8 i;
+
+    if (PIE1bits.TMR2IE && PIR1bits.TMR2IF)
+    {
+        PIR1bits.TMR2IF = 0;
+
+        if (pwmCommit & PWM_COMMIT_LATCHED)
         {
-            CCPR1L = duty;
-            break;//blue
-            // ledul albastru merge la 70% mereu
-                        //potentiometrul merge pana la 255
-            //asta inseamna ca 70/100 * 255 = 178 . 
-        }//rc2 este blue pt ca l-am infipt in pinul pc2 de pe placa si firul de curent duce la ledul blue 
-        case RC1_0:
+            PR2 = pwmNextPr2;
+            T2CON = pwmNextT2con;
+            pwmPeriodTcy = pwmNextTcy;
+            pwmCommit &= ~PWM_COMMIT_LATCHED;
+        }
+
+        if (FadeActive())
         {
-            CCPR2L = duty;
-            break;//G
+            pwmFadeTcy += pwmPeriodTcy;
+            if (pwmFadeTcy >= FADE_STEP_TCY)
+            {
+                pwmFadeTcy -= FADE_STEP_TCY;
+                fadeNew = FadeStep(fadeDuty);
+                for (i = 0; i < PWM_CHANNELS; i++)
+                {
+                    if (fadeNew & (1 << i))
+                    {
+                        pwmFadeDuty(i, fadeDuty[i]);
+                    }
+                }
+                pwmCommit |= PWM_COMMIT_DUTY;
+            }
         }
-        case RG0_0:
+
+        if (pwmCommit & PWM_COMMIT_DUTY)
         {
-            CCPR3L = duty;
-            break;//R   
+            CCPR1L = pwmShadow.ccprl[RC2_0];
+            CCP1CONbits.DC1B = pwmShadow.dcb[RC2_0];
+            CCPR2L = pwmShadow.ccprl[RC1_0];
+            CCP2CONbits.DC2B = pwmShadow.dcb[RC1_0];
+            CCPR3L = pwmShadow.ccprl[RG0_0];
+            CCP3CONbits.DC3B = pwmShadow.dcb[RG0_0];
+
+            if (pwmCommit & PWM_COMMIT_PERIOD)
+            {
+                /* the period these duties were calculated for */
+                pwmNextPr2 = pwmShadow.pr2;
+                pwmNextT2con = pwmShadow.t2con;
+                pwmNextTcy = pwmShadow.tcy;
+                pwmCommit |= PWM_COMMIT_LATCHED;
+            }
+            pwmCommit &= ~(PWM_COMMIT_DUTY | PWM_COMMIT_PERIOD);
+        }
+
+        if (!pwmCommit && !FadeActive())
+        {
+            PIE1bits.TMR2IE = 0;
         }
     }
 }
 
-void setPeriod(uint8 period)
-{
-	PR2 = period;
-}
 //aplicatia 2 sa creasca ledul verde de la 0 la 100 
 void LedAction()
 {
     
 }
-static uint8 unit = 0;
-static int state = 0;
 void LedControl()
 {   
     //aplicatia 3 . led rosu care se modifica cu potentiometru
     uint8 potiValue;
     Adc_GetMess(&potiValue);
-    setDuty(RG0_0,potiValue);
+    setBrightness(RG0_0,potiValue);
     //////////////////////
     
     //aplicatia 1 . led albastru la 70%
-    setDuty(RC2_0,178);//aplicatia 1
+    setDuty(RC2_0,PWM_DUTY_PCT(70));//aplicatia 1
     //////////////////
     
     //aplicatia 2 , led galben oscileaza automat intre 0 si 100%
-    if(unit < 255 && state == 0){
-     setDuty(RC1_0,unit);
-     unit++;
-    }
-    if (unit == 255 && state == 0){
-        state = 1;
-    }
-    if (unit <= 255 && state == 1){
-        setDuty(RC1_0,unit);
-        unit--;
-    }
-    if (unit == 0 && state == 1){
-        state = 0;
-    }
-     _delay(25000);
+    //ruleaza din intreruperea TMR2, vezi FadeSet() in main
 ////////////////
      
     //Add your code here
@@ -1,19 +1,29 @@
 #ifndef PWM_H
 #define PWM_H
 #include "Types.h"
+#include "PwmCfg.h"
 
-extern void setDuty(uint8 chanId,uint8 duty);
+extern void setDuty(uint8 chanId,uint16 duty);
+extern void setBrightness(uint8 chanId, uint8 level);
 extern void setPeriod(uint8 period);
+extern void setPeriodReg(uint8 pr2, uint8 t2con);
+extern uint8 setPeriodUs(uint16 us);
+extern uint8 setFrequency(uint16 hz);
 extern void LedAction();
 extern void LedControl();
 
 extern void PwmInit();
+extern void PwmIsr();
 extern void InteruptInit();
 
 #define RC2_0 0
 #define RC1_0 1
 #define RG0_0 2
 
+#define PWM_CHANNELS 3
+
+#define PWM_DUTY_MAX 1023       /* 10 bit duty, fraction of the period, 1023 = 100% */
+
 #define OLD_VALUE 0
 #define NEW_VALUE 1
 
@@ -0,0 +1,79 @@
+#ifndef PWM_CFG_H
+#define PWM_CFG_H
+
+/* PWM timing calculated by the preprocessor (replaces Duty_Period_Calculation.xlsx)
+ *
+ *   period = 4 * Tosc * presc * (PR2 + 1)
+ *   duty   = Tosc * presc * (CCPRxL:DCxB)      => 4*(PR2+1) counts = 100%
+ *
+ * the smallest TMR2 prescaler which fits the period is used, it gives the
+ * most duty counts (resolution); a request which can not be built stops the
+ * compilation with #error instead of a wrong constant
+ */
+
+#define PWM_FOSC 10000000UL     /* oscillator (Hz), change only with the crystal */
+
+#define PWM_FREQ_SLOW 2500UL    /* Hz, 400us, after reset */
+#define PWM_FREQ_FAST 5000UL    /* Hz, 200us, after INT0 */
+
+#define PWM_MIN_BITS 8          /* least duty resolution accepted (bits) */
+#define PWM_MAX_ERR 10          /* largest frequency error accepted (per mille) */
+
+/* Tcy counts of one period */
+#define PWM_CFG_COUNTS(f)   ((PWM_FOSC / 4UL + (f) / 2UL) / (f))
+
+/* TMR2 prescaler 1, 4 or 16 */
+#define PWM_CFG_PRESC(f)    (PWM_CFG_COUNTS(f) <= 256UL ? 1UL :  \
+                             PWM_CFG_COUNTS(f) <= 1024UL ? 4UL : 16UL)
+
+/* PR2, rounded to the closest period */
+#define PWM_CFG_PR2(f)      ((PWM_CFG_COUNTS(f) + PWM_CFG_PRESC(f) / 2UL) / PWM_CFG_PRESC(f) - 1UL)
+
+/* T2CON: TMR2ON, postscaler 1:1, T2CKPS */
+#define PWM_CFG_T2CON(f)    (0b00000100 | (PWM_CFG_PRESC(f) == 1UL ? 0b00 :   \
+                                           PWM_CFG_PRESC(f) == 4UL ? 0b01 : 0b10))
+
+/* what the hardware really does */
+#define PWM_CFG_FREQ_REAL(f) (PWM_FOSC / (4UL * PWM_CFG_PRESC(f) * (PWM_CFG_PR2(f) + 1UL)))
+#define PWM_CFG_STEPS(f)    (4UL * (PWM_CFG_PR2(f) + 1UL))  /* duty counts for 100% */
+#define PWM_CFG_BITS(f)     (PWM_CFG_STEPS(f) >= 1024UL ? 10 : \
+                             PWM_CFG_STEPS(f) >= 512UL ? 9 :   \
+                             PWM_CFG_STEPS(f) >= 256UL ? 8 :   \
+                             PWM_CFG_STEPS(f) >= 128UL ? 7 :   \
+                             PWM_CFG_STEPS(f) >= 64UL ? 6 : 5)
+#define PWM_CFG_ERR(f)      ((PWM_CFG_FREQ_REAL(f) > (f) ?          \
+                              PWM_CFG_FREQ_REAL(f) - (f) :          \
+                              (f) - PWM_CFG_FREQ_REAL(f)) * 1000UL / (f))
+
+/* duty counts (CCPRxL:DCxB) for pct % of the period f */
+#define PWM_CFG_DUTY_COUNTS(f, pct) ((PWM_CFG_STEPS(f) * (pct) + 50UL) / 100UL)
+#define PWM_CFG_CCPRL(f, pct)       (PWM_CFG_DUTY_COUNTS(f, pct) >> 2)
+#define PWM_CFG_DCB(f, pct)         (PWM_CFG_DUTY_COUNTS(f, pct) & 0x03)
+
+/* pct % as setDuty() argument (fraction of PWM_DUTY_MAX, any period) */
+#define PWM_DUTY_PCT(pct)   ((1023UL * (pct) + 50UL) / 100UL)
+
+
+/* build time checks */
+#if (PWM_CFG_COUNTS(PWM_FREQ_SLOW) > 4096UL) || (PWM_CFG_COUNTS(PWM_FREQ_FAST) > 4096UL)
+#error "PWM frequency too low for TMR2, prescaler 1:16 and PR2 = 0xFF are not enough"
+#endif
+
+#if (PWM_CFG_COUNTS(PWM_FREQ_SLOW) < 2UL) || (PWM_CFG_COUNTS(PWM_FREQ_FAST) < 2UL)
+#error "PWM frequency higher than Fosc/8"
+#endif
+
+#if (PWM_CFG_BITS(PWM_FREQ_SLOW) < PWM_MIN_BITS) || (PWM_CFG_BITS(PWM_FREQ_FAST) < PWM_MIN_BITS)
+#error "PWM frequency too high for PWM_MIN_BITS of duty resolution"
+#endif
+
+#if (PWM_CFG_ERR(PWM_FREQ_SLOW) > PWM_MAX_ERR) || (PWM_CFG_ERR(PWM_FREQ_FAST) > PWM_MAX_ERR)
+#error "PWM frequency can not be reached within PWM_MAX_ERR"
+#endif
+
+/* Fosc = 10MHz:
+ *   PWM_FREQ_SLOW 2500Hz => 1:4, PR2 = 249, 2500Hz, 1000 steps (9 bits)
+ *   PWM_FREQ_FAST 5000Hz => 1:4, PR2 = 124, 5000Hz,  500 steps (8 bits)
+ */
+
+#endif
\ No newline at end of file
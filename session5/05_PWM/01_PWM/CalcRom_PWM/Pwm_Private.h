@@ -1,5 +1,23 @@
 #ifndef PWM_PRIVATE_H
 #define PWM_PRIVATE_H
+#include "Types.h"
 
+/* register values prepared by the API, copied by PwmIsr() at a period edge */
+typedef struct
+{
+    uint8 pr2;
+    uint8 t2con;
+    uint16 tcy;                 /* period length in Tcy, prescaler * (PR2 + 1) */
+    uint8 ccprl[PWM_CHANNELS];  /* 8 MSB of the duty counts */
+    uint8 dcb[PWM_CHANNELS];    /* 2 LSB of the duty counts */
+} PwmShadow_t;
+
+#define PWM_COMMIT_DUTY   0x01  /* CCPRxL/DCxB to be written, latched by HW at the next edge */
+#define PWM_COMMIT_PERIOD 0x02  /* PR2/T2CON changed, goes with the next duty write */
+#define PWM_COMMIT_LATCHED 0x04 /* duties written, PR2/T2CON at the edge they are latched */
+
+#define T2CON_ON_PRESC_1  0b00000100
+#define T2CON_ON_PRESC_4  0b00000101
+#define T2CON_ON_PRESC_16 0b00000110
 
 #endif
\ No newline at end of file
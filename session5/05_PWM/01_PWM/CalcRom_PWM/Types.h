@@ -2,6 +2,8 @@
 #define PWM_TYPES_H
 
 typedef unsigned char uint8;
+typedef unsigned int uint16;
+typedef unsigned long uint32;
 
 
 #endif
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "Pwm.h"
+#include "tick.h"
+#include "Fade.h"
 
 #include <xc.h>
 
@@ -12,34 +14,58 @@
 #pragma config LVP = OFF
 #pragma config XINST = OFF
 
+#define INT0_LOCKOUT_MS 50 // bounces of the RB0 button after an accepted edge are ignored
+
+extern volatile tick_t tickCount;
+
+static volatile uint8 int0Ev = 0;
+static tick_t int0Stamp = 0;
+
 void interrupt intrerupt_ext (void)
 {
-    static uint8 tempValue = OLD_VALUE;
+    /* 1ms system tick, first, the INT0 edge is stamped with the current ms */
+    TickIsr();
 
     if(INTCONbits.INT0IE && INTCONbits.INT0IF)
     {
-        if(tempValue == OLD_VALUE)
-        {
-            setPeriod(0x7D);
-            tempValue = NEW_VALUE;
-        }
-        else
+        INTCONbits.INT0IF = 0;
+        if((tick_t)(tickCount - int0Stamp) >= TICK_MS(INT0_LOCKOUT_MS))
         {
-            setPeriod(0xFF);
-            tempValue = OLD_VALUE;
+            int0Stamp = tickCount;
+            int0Ev = 1; // the period is changed from main, the PWM API is not reentrant
         }
-        INTCONbits.INT0IF = 0;
     }
+
+    /* PWM period edge, commit of the new duties/period */
+    PwmIsr();
 }
 
 void main()
 {
-   
+    uint8 tempValue = OLD_VALUE;
+
     PwmInit();
     InteruptInit();
-    setPeriod(0xFF);
+    TickInit();
+    FadeInit();
+    setPeriodReg(PWM_CFG_PR2(PWM_FREQ_SLOW), PWM_CFG_T2CON(PWM_FREQ_SLOW));
+    FadeSet(RC1_0, FADE_RAMP, FADE_SPEED_MS(5120), 0); // galben 0..100..0% in 5.12s, ca unit++/unit-- la 10ms
     while(1)
     {
+        if(int0Ev)
+        {
+            int0Ev = 0;
+            if(tempValue == OLD_VALUE)
+            {
+                setPeriodReg(PWM_CFG_PR2(PWM_FREQ_FAST), PWM_CFG_T2CON(PWM_FREQ_FAST));
+                tempValue = NEW_VALUE;
+            }
+            else
+            {
+                setPeriodReg(PWM_CFG_PR2(PWM_FREQ_SLOW), PWM_CFG_T2CON(PWM_FREQ_SLOW));
+                tempValue = OLD_VALUE;
+            }
+        }
         LedControl();
     }
 }
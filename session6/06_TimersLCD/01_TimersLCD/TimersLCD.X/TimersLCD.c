@@ -13,6 +13,9 @@
 #include "TimersLCD.h"
 #include "lcd.h"
 #include "uart.h"
+#include "debounce.h"
+#include "gesture.h"
+#include "fmt.h"
 
 
 // configuration bits
@@ -32,6 +35,26 @@
 
 typedef unsigned char byte;
 
+/* push buttons, active low, debounced by the 4ms timer interrupt
+ * (DEB_SAMPLES * 4ms = 16ms), one bit per button in the edge masks
+ */
+#define BTN_LEFT        (1<<0)  // RB0
+#define BTN_RIGHT       (1<<5)  // RA5
+#define BTN_PORTB_MASK  (BTN_LEFT)
+#define BTN_PORTA_MASK  (BTN_RIGHT)
+
+#define TMR_EV_TICKS    25      // 25 * 4ms = 100ms main cycle
+#define TMR_TICK_MS     4       // ms between two interrupts
+
+/* right button gestures set the watch
+ *  click           +1 minute
+ *  double click    +1 hour
+ *  long press/hold +1 minute, then +1 minute each 200ms
+ */
+#define BTN_DOUBLE_TIME 300     // time (ms)
+#define BTN_LONG_TIME   600     // time (ms)
+#define BTN_REPEAT_TIME 200     // time (ms)
+
 void checkInputs(void);
 void initButtons(void);
 void init(void);
@@ -43,12 +66,19 @@ void main(void);
  * Global variables
  */
 byte leftButtonEv = 0;
-byte rightButtonEv = 0;
+byte rightButtonEv = 0;     /* gest_e of the right button */
+
+/* debounced push buttons */
+deb_t buttonsA;
+deb_t buttonsB;
+gest_t gestRight;
+const gest_cfg_t gestRightCfg = { BTN_DOUBLE_TIME, BTN_LONG_TIME, BTN_REPEAT_TIME };
 
 /* timer related variables */
 unsigned char tick = 0;
 unsigned char ev = 0;
-//unsigned char cnt = 0;
+unsigned char cnt = 0;
+unsigned int tickMs = 0;    /* ms since reset, time stamps of the gestures */
 
 /* used to format print messages */
 char mesaj[20] = {0};
@@ -97,30 +127,14 @@ unsigned char ore = 0;
  */
 void checkInputs(void)
 {
-    byte leftButton = 0;
-    byte rightButton = 0;
-    static byte leftButton_old = 0;
-    static byte rightButton_old = 0;
-
 /* RB0 - check left push button event */
-    leftButton = PORTBbits.RB0;
-    if (   (leftButton == 0) /* push button pressed */
-        && (leftButton != leftButton_old) /* not pressed before */
-       )
+    if (DebPressed(&buttonsB, BTN_LEFT))
     {
         leftButtonEv = 1;
     }
-    leftButton_old = leftButton;
 
-/* RA5 - check right push button event */
-    rightButton = PORTAbits.RA5;
-    if (   (rightButton == 0) /* push button pressed */
-        && (rightButton != rightButton_old) /* not pressed before */
-       )
-    {
-        rightButtonEv = 1;
-    }
-    rightButton_old = rightButton;
+/* RA5 - check right push button gesture */
+    rightButtonEv = GestGet(&gestRight);
 } /* void checkInputs(void) */
 
 
@@ -137,6 +151,9 @@ void initButtons(void)
     /* RA5 right push button */
     TRISA5 = 1; /* only RA5 as input */
 
+    DebInit(&buttonsB, ~PORTB & BTN_PORTB_MASK);
+    DebInit(&buttonsA, ~PORTA & BTN_PORTA_MASK);
+    GestInit(&gestRight, &gestRightCfg);
 } /* void initButtons(void) */
 
 
@@ -160,13 +177,13 @@ void initTmr(void)
     T0CONbits.T0SE = 0;     // source edge Low-2-High
     T0CONbits.PSA = 0;      // prescaler active
     T0CONbits.T0PS = 1;     // prescaler 3 bits (Fosc/4)/presc 1:4 => timer clock = (10MHz/4) / 4 = 625Khz
-    /* 10Hz */
-    /* 10Hz = 0.01KHz => 100ms period
-     * 625Khz / 0.01khz => 62500
-     * 65535 - 62500 = 3035 = 0BDBx
+    /* 250Hz, 4ms period for the debouncer, each 25th interrupt => 100ms */
+    /* 250Hz = 0.25KHz => 4ms period
+     * 625Khz / 0.25khz => 2500
+     * 65536 - 2500 = 63036 = F63Cx
      */
-    TMR0H = 0x0B;           //
-    TMR0L = 0xDB;           //
+    TMR0H = 0xF6;           //
+    TMR0L = 0x3C;           //
     T0IE = 1; //enable TMR0 overflow interrupts
     GIE = 1; //enable Global interrupts
     T0CONbits.TMR0ON = 1;   // timer ON
@@ -184,12 +201,26 @@ void interrupt ISR(void)
     {
         T0IF  = 0;              // clear interrupt flag
         T0CONbits.TMR0ON = 0;   // Turn timer off to reset count register
-        TMR0H = 0x0B;           // reload counter for 100ms interrupt
-        TMR0L = 0xDB;           //
+        TMR0H = 0xF6;           // reload counter for 4ms interrupt
+        TMR0L = 0x3C;           //
 
 
         T0CONbits.TMR0ON = 1;   // Turn timer back on
-        ev = 1;
+        tick++; // each 4ms
+        tickMs += TMR_TICK_MS;
+
+        DebSample(&buttonsB, ~PORTB & BTN_PORTB_MASK);
+        DebSample(&buttonsA, ~PORTA & BTN_PORTA_MASK);
+        /* nothing to do while released and idle */
+        if (DebState(&buttonsA, BTN_RIGHT) || GestBusy(&gestRight))
+            GestUpdate(&gestRight, DebState(&buttonsA, BTN_RIGHT), tickMs);
+
+        cnt++;
+        if (cnt == TMR_EV_TICKS) // each 25*4ms = 100ms
+        {
+            ev = 1;
+            cnt = 0;
+        }
 
         PORTJbits.RJ0 = tick&1;
     }
@@ -228,6 +259,8 @@ void init(void)
  */
 void main(void)
 {
+    char *p;
+
     init();
 
     TRISDbits.RD0 = 0;
@@ -284,7 +317,7 @@ void main(void)
         /* 0x40 is the offset for the second line on LCD, 0 is the first char on the line, 15 is the last char on the line */
         LcdGoTo(0x40+12);
         /* format the seconds value in a string */
-        sprintf(mesaj, "%04d", secunde);
+        FmtUint(mesaj, secunde, 4, '0');
         /* put the message on LCD */
         LcdWriteString(mesaj);
 
@@ -346,13 +379,32 @@ void main(void)
             /* YOUR CODE */
         }
 
+        /* right button sets the watch */
+        if (rightButtonEv == GEST_DOUBLE)
+        {
+            ore++;
+        }
+        else if (rightButtonEv != GEST_NONE) /* click, long press, repeat */
+        {
+            minute++;
+            if (minute == 60)
+            {
+                minute = 0;
+                ore++;
+            }
+        }
+
         /* display on LCD HH:MM:SS */
         /* 0x40 is the offset for the second line on LCD, 0 is the first char on the line */
         /* YOUR CODE */
         LcdGoTo(0x40+8);
         /* format the seconds value in a string */
         /* YOUR CODE */
-        sprintf(mesaj, "%02d:%02d:%02d", ore,minute,secunde);
+        p = FmtUint(mesaj, ore, 2, '0');
+        *p++ = ':';
+        p = FmtUint(p, minute, 2, '0');
+        *p++ = ':';
+        FmtUint(p, secunde, 2, '0');
         
         
         /* put the message on LCD */
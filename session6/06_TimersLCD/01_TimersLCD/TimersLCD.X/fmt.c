@@ -0,0 +1,187 @@
+/*
+ * File:   fmt.c
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 9:40 PM
+ */
+
+#include "fmt.h"
+#include "bcd.h"
+
+
+#define FMT_DIGITS_MAX  5       /* 65535 */
+
+const unsigned int fmtPow10[FMT_DIGITS_MAX] = { 10000, 1000, 100, 10, 1 };
+const char fmtHexDigit[16] = "0123456789ABCDEF";
+
+
+
+/*******************************************************************************
+ * Format Length Function
+ *  - number of decimal digits of val, 1 for 0
+ */
+unsigned char fmtLen(unsigned int val)
+{
+    unsigned char n = FMT_DIGITS_MAX;
+
+    while ((n > 1) && (val < fmtPow10[FMT_DIGITS_MAX - n]))
+        n--;
+
+    return n;
+} /* unsigned char fmtLen(unsigned int val) */
+
+
+
+/*******************************************************************************
+ * Format Digits Function
+ *  - the last n decimal digits of val
+ */
+char *fmtDigits(char *dst, unsigned int val, unsigned char n)
+{
+    unsigned char digits[FMT_DIGITS_MAX];
+    unsigned char i;
+
+    Bcd16(val, digits);
+    for (i = FMT_DIGITS_MAX - n; i < FMT_DIGITS_MAX; i++)
+        *dst++ = '0' + digits[i];
+    *dst = '\0';
+
+    return dst;
+} /* char *fmtDigits(char *dst, unsigned int val, unsigned char n) */
+
+
+
+/*******************************************************************************
+ * Format Pad Function
+ *  - width - len pad characters, nothing if the text is already as wide
+ */
+char *fmtPad(char *dst, unsigned char width, unsigned char len, char pad)
+{
+    while (width > len)
+    {
+        *dst++ = pad;
+        width--;
+    }
+
+    return dst;
+} /* char *fmtPad(char *dst, unsigned char width, unsigned char len, char pad) */
+
+
+
+/*******************************************************************************
+ * Format Unsigned Function
+ *  - "%u", "%5u", "%02u"
+ */
+char *FmtUint(char *dst, unsigned int val, unsigned char width, char pad)
+{
+    unsigned char n = fmtLen(val);
+
+    dst = fmtPad(dst, width, n, pad);
+
+    return fmtDigits(dst, val, n);
+} /* char *FmtUint(char *dst, unsigned int val, unsigned char width, char pad) */
+
+
+
+/*******************************************************************************
+ * Format Signed Function
+ *  - "%d", "%3d" (" -5"), "%03d" ("-05")
+ */
+char *FmtInt(char *dst, int val, unsigned char width, char pad)
+{
+    unsigned int u;
+    unsigned char n;
+
+    if (val >= 0)
+        return FmtUint(dst, (unsigned int)val, width, pad);
+
+    u = -(unsigned int)val;
+    n = fmtLen(u);
+
+    if (pad == '0')
+    {
+        *dst++ = '-';
+        dst = fmtPad(dst, width, n + 1, '0');
+    }
+    else
+    {
+        dst = fmtPad(dst, width, n + 1, pad);
+        *dst++ = '-';
+    }
+
+    return fmtDigits(dst, u, n);
+} /* char *FmtInt(char *dst, int val, unsigned char width, char pad) */
+
+
+
+/*******************************************************************************
+ * Format Hex Function
+ *  - "%0nX", digits 1..4
+ */
+char *FmtHex(char *dst, unsigned int val, unsigned char digits)
+{
+    unsigned char shift = digits << 2;
+
+    while (shift)
+    {
+        shift -= 4;
+        *dst++ = fmtHexDigit[(val >> shift) & 0x0F];
+    }
+    *dst = '\0';
+
+    return dst;
+} /* char *FmtHex(char *dst, unsigned int val, unsigned char digits) */
+
+
+
+/*******************************************************************************
+ * Format Fixed Point Function
+ *  - val in 0.1 units, one decimal: 235 => "23.5", -5 => "-0.5"
+ *  - padded with spaces up to width
+ */
+char *FmtFix1(char *dst, int val, unsigned char width)
+{
+    unsigned int u;
+    unsigned char n;
+    unsigned char neg = 0;
+
+    if (val < 0)
+    {
+        neg = 1;
+        u = -(unsigned int)val;
+    }
+    else
+        u = (unsigned int)val;
+
+    n = fmtLen(u);
+    if (n < 2)
+        n = 2;          /* 0.x */
+
+    dst = fmtPad(dst, width, n + 1 + neg, ' ');
+    if (neg)
+        *dst++ = '-';
+
+    /* digits, then the last one is moved right to make room for the point */
+    dst = fmtDigits(dst, u, n);
+    dst[0] = dst[-1];
+    dst[-1] = '.';
+    dst++;
+    *dst = '\0';
+
+    return dst;
+} /* char *FmtFix1(char *dst, int val, unsigned char width) */
+
+
+
+/*******************************************************************************
+ * Format String Function
+ *  - copies s, for chained texts
+ */
+char *FmtStr(char *dst, const char *s)
+{
+    while (*s)
+        *dst++ = *s++;
+    *dst = '\0';
+
+    return dst;
+} /* char *FmtStr(char *dst, const char *s) */
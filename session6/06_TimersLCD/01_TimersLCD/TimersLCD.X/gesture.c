@@ -0,0 +1,124 @@
+/*
+ * File:   gesture.c
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 8:05 PM
+ */
+
+#include <p18f8722.h>
+
+#include "gesture.h"
+
+
+/* states of gest_t, GEST_IDLE must stay 0 (GestBusy()) */
+#define GEST_IDLE       0   /* released, nothing pending */
+#define GEST_DOWN       1   /* pressed, not long yet */
+#define GEST_GAP        2   /* released after a short press, double click? */
+#define GEST_HELD       3   /* long press reported, repeating */
+#define GEST_WAIT_UP    4   /* double click reported, wait for the release */
+
+
+
+/*******************************************************************************
+ * Gesture Init Function
+ */
+void GestInit(gest_t *g, const gest_cfg_t *cfg)
+{
+    g->cfg = cfg;
+    g->state = GEST_IDLE;
+    g->stamp = 0;
+    g->event = GEST_NONE;
+} /* void GestInit(gest_t *g, const gest_cfg_t *cfg) */
+
+
+
+/*******************************************************************************
+ * Gesture Update Function
+ *  - called from the timer ISR, pressed: debounced level, now: ms time stamp
+ *  - the time differences are unsigned, the 16 bit tick may wrap
+ */
+void GestUpdate(gest_t *g, unsigned char pressed, unsigned int now)
+{
+    unsigned int held = now - g->stamp;
+
+    switch (g->state)
+    {
+        case GEST_IDLE:
+            if (pressed)
+            {
+                g->state = GEST_DOWN;
+                g->stamp = now;
+            }
+            break;
+
+        case GEST_DOWN:
+            if (!pressed)
+            {
+                if (g->cfg->doubleMs)
+                {
+                    g->state = GEST_GAP;
+                    g->stamp = now;
+                }
+                else
+                {
+                    g->event = GEST_CLICK;
+                    g->state = GEST_IDLE;
+                }
+            }
+            else if (held >= g->cfg->longMs)
+            {
+                g->event = GEST_LONG;
+                g->state = GEST_HELD;
+                g->stamp = now;
+            }
+            break;
+
+        case GEST_GAP:
+            if (pressed)
+            {
+                g->event = GEST_DOUBLE;
+                g->state = GEST_WAIT_UP;
+            }
+            else if (held >= g->cfg->doubleMs)
+            {
+                g->event = GEST_CLICK;
+                g->state = GEST_IDLE;
+            }
+            break;
+
+        case GEST_HELD:
+            if (!pressed)
+            {
+                g->state = GEST_IDLE;
+            }
+            else if (g->cfg->repeatMs && (held >= g->cfg->repeatMs))
+            {
+                g->event = GEST_REPEAT;
+                g->stamp += g->cfg->repeatMs;   /* no drift */
+            }
+            break;
+
+        default: /* GEST_WAIT_UP */
+            if (!pressed)
+                g->state = GEST_IDLE;
+            break;
+    }
+} /* void GestUpdate(gest_t *g, unsigned char pressed, unsigned int now) */
+
+
+
+/*******************************************************************************
+ * Gesture Get Function
+ *  - returns and clears the last event
+ */
+gest_e GestGet(gest_t *g)
+{
+    gest_e ev;
+
+    GIE = 0;                /* the ISR writes the event */
+    ev = (gest_e)g->event;
+    g->event = GEST_NONE;
+    GIE = 1;
+
+    return ev;
+} /* gest_e GestGet(gest_t *g) */
@@ -0,0 +1,72 @@
+/*
+ * File:   gesture.h
+ * Author: Dragos
+ *
+ * Created on October 19, 2026, 8:05 PM
+ */
+
+#ifndef GESTURE_H
+#define	GESTURE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+
+/* button gestures on top of the debounced level (debounce.h)
+ *
+ *   click        press + release, no second press within doubleMs
+ *   double click second press within doubleMs after a release
+ *   long press   held for longMs, no click follows
+ *   repeat       still held, each repeatMs after the long press
+ *
+ *   IDLE --press--> DOWN --release--> GAP --doubleMs--> IDLE   (click)
+ *                    |                 |
+ *                    | longMs          +--press--> WAIT_UP     (double)
+ *                    v
+ *                   HELD --repeatMs--> HELD                    (repeat)
+ *
+ * GestUpdate() runs in the timer ISR with the time stamp of the system tick,
+ * it returns at once while the button is released and nothing is pending
+ * (see GestBusy()), the last event is latched until GestGet() reads it
+ */
+
+typedef enum
+{
+    GEST_NONE = 0,
+    GEST_CLICK,
+    GEST_DOUBLE,
+    GEST_LONG,
+    GEST_REPEAT
+} gest_e;
+
+typedef struct
+{
+    unsigned int doubleMs;  /* gap for double click, 0 - no double click, click at release */
+    unsigned int longMs;    /* held time for long press */
+    unsigned int repeatMs;  /* period of repeat after long press, 0 - no repeat */
+} gest_cfg_t;
+
+typedef struct
+{
+    const gest_cfg_t *cfg;  /* timings, usually a const in ROM */
+    unsigned char state;    /* see the diagram */
+    unsigned int stamp;     /* ms, last press/release/repeat */
+    unsigned char event;    /* gest_e, latched until GestGet() */
+} gest_t;
+
+
+/* pressed or an event still has to be decided, GestUpdate() has work to do */
+#define GestBusy(g)     ((g)->state != 0)
+
+void GestInit(gest_t *g, const gest_cfg_t *cfg);
+void GestUpdate(gest_t *g, unsigned char pressed, unsigned int now);
+gest_e GestGet(gest_t *g);
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* GESTURE_H */
+
@@ -10,10 +10,10 @@
 
 #include <p18f8722.h>
 #include <spi.h>
-#include <delays.h>
 
 #include "StateMachine.h"
 #include "LCD.h"
+#include "tick.h"
 
 // configuration bits
 #pragma config OSC = HS       // Oscillator Selection bits (HS oscillator)
@@ -38,6 +38,7 @@ typedef unsigned char byte;
 
 #define ON          1
 #define OFF         0
+#define STATE_TWO_TIME  (10000)   /* time spent in STATE 2 (ms) */
 /*******************************************************************************
  * State machine example
  */
@@ -46,6 +47,7 @@ state_e last_state;
 byte RD5Led;
 byte RD8Led;
 byte leftButtonEv = 0;
+tick_t stateTime;           /* tick when the current state was entered */
 
 /*******************************************************************************
  * Set RD5 LED Function
@@ -105,25 +107,9 @@ void checkInput(void)
 
 } /* void checkInput(void) */
 
-/*******************************************************************************
- * Delay of 1s Function
- */
-void Delay1s (int x)
-{
-    int i;
-    for (i=0; i<x; i++)
-    {
-        /* Fosc = 10MHz
-         * 10000 x 250 x 4 x (1/10e6) = 1s
-         */
-        Delay10KTCYx(250);
-    }
-}/* void Delay1s(int x) */
-
 /*******************************************************************************
  * State Machine Function
  */
-static int counter = 0;
 void stateMachine(void)
 {   
     switch(state){
@@ -143,14 +129,11 @@ void stateMachine(void)
             setLcd();
             setRD5Led(ON);
             last_state = state;
+            stateTime = TickGet(); /* start measuring the 10s */
             }
-            counter++;
-            if(counter == 20000){
+            if(TickElapsed(stateTime, TICK_MS(STATE_TWO_TIME))){
                 state = STATE_THREE;
-                counter = 0;
             }
-            //Delay1s (10);
-            
             break;
         case STATE_THREE: 
              if(last_state != state){
@@ -192,6 +175,15 @@ void initButtons(void)
 } /* void initButtons(void) */
 
 
+/*******************************************************************************
+ * Interrupt Service Routine (keyword "interrupt" tells the compiler it's an ISR)
+ */
+void interrupt ISR(void)
+{
+    /* 1ms system tick */
+    TickIsr();
+} /* void interrupt ISR(void) */
+
 /*******************************************************************************
  * Init Function
  */
@@ -199,6 +191,9 @@ void init(void)
 {
     /* init buttons */
     initButtons();
+
+    /* init 1ms system tick */
+    TickInit();
  
     TRISD=0;
     MEMCONbits.EBDIS=1;
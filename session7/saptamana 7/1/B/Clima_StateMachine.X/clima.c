@@ -374,7 +374,7 @@ void stateMachine(void)
 {
     switch(climaState){
     case STATE_OFF:
-        if(lastState =! climaState){
+        if(lastState != climaState){
             setLcd();
             lastState = climaState;
             setCoolElement(OFF);
@@ -388,7 +388,7 @@ void stateMachine(void)
         break;
         
         case STATE_ON_VENT:
-            if(lastState =! climaState){
+            if(lastState != climaState){
                 updateLcd();
 
                 lastState = climaState;
@@ -398,8 +398,7 @@ void stateMachine(void)
             }
             if(leftButtonEv == 1){
                 climaState = STATE_OFF;
-            }
-            if(inTemp =! setTemp){
+            }else if(inTemp != setTemp){
                 if(inTemp > setTemp){
                     climaState = STATE_ON_COOL;
                 }else{
@@ -408,7 +407,7 @@ void stateMachine(void)
             }
             break;
         case STATE_ON_COOL:
-            if(lastState =! climaState){
+            if(lastState != climaState){
                 updateLcd();
 
                 lastState = climaState;
@@ -417,8 +416,7 @@ void stateMachine(void)
             }
             if(leftButtonEv == 1){
                 climaState = STATE_OFF;
-            }
-            if(inTemp == setTemp){
+            }else if(inTemp == setTemp){
                 climaState = STATE_ON_VENT;
             }else{
                 if(inTemp < setTemp){
@@ -427,7 +425,7 @@ void stateMachine(void)
             }
             break;
         case STATE_ON_HEAT:
-            if(lastState =! climaState){
+            if(lastState != climaState){
                 updateLcd();
 
                 lastState = climaState;
@@ -436,12 +434,11 @@ void stateMachine(void)
             }
             if(leftButtonEv == 1){
                 climaState = STATE_OFF;
-            }
-            if(inTemp == setTemp){
+            }else if(inTemp == setTemp){
                 climaState = STATE_ON_VENT;
             }else{
-                if(inTemp < setTemp){
-                    climaState = STATE_ON_HEAT;
+                if(inTemp > setTemp){
+                    climaState = STATE_ON_COOL;
                 }
             }
             break;
@@ -223,7 +223,7 @@ byte getOnOffButton(void)
  */
 void setLcd(void)
 {
-    LcdClear();
+    /* all 32 cells are rewritten in place, lcd.c sends only the changed ones */
     LcdGoTo(0); /* first Line */
     LcdWriteString(LcdLines[climaState][0]);
     LcdGoTo(0x40); /* second Line */
@@ -397,7 +397,7 @@ void stateMachine(void)
         case STATE_OFF:
         {
             /* TODO*/
-            if(lastState =! climaState){
+            if(lastState != climaState){
             setLcd();
             lastState = climaState;
             setCoolElement(OFF);
@@ -414,7 +414,7 @@ void stateMachine(void)
         case STATE_ON_COOL:
         {
             /* TODO*/
-            if(lastState =! climaState){
+            if(lastState != climaState){
                 updateLcd();
                 lastState = climaState;
                 setCoolElement(ON);
@@ -446,8 +446,7 @@ void stateMachine(void)
             }
             if(leftButtonEv == 1){
                 climaState = STATE_OFF;
-            }
-            if(inTemp == setTemp){
+            }else if(inTemp == setTemp){
                 climaState = STATE_ON_VENT;
             }else{
                 if(inTemp < setTemp){
@@ -459,7 +458,7 @@ void stateMachine(void)
         case STATE_ON_HEAT:
         {
             /* TODO*/
-            if(lastState =! climaState){
+            if(lastState != climaState){
                 updateLcd();
 
                 lastState = climaState;
@@ -486,12 +485,11 @@ void stateMachine(void)
             }
             if(leftButtonEv == 1){
                 climaState = STATE_OFF;
-            }
-            if(inTemp == setTemp){
+            }else if(inTemp == setTemp){
                 climaState = STATE_ON_VENT;
             }else{
-                if(inTemp < setTemp){
-                    climaState = STATE_ON_HEAT;
+                if(inTemp > setTemp){
+                    climaState = STATE_ON_COOL;
                 }
             }
             break;
@@ -499,7 +497,7 @@ void stateMachine(void)
         case STATE_ON_VENT:
         {
             /* TODO*/
-            if(lastState =! climaState){
+            if(lastState != climaState){
                 updateLcd();
 
                 lastState = climaState;
@@ -509,8 +507,7 @@ void stateMachine(void)
             }
             if(leftButtonEv == 1){
                 climaState = STATE_OFF;
-            }
-            if(inTemp =! setTemp){
+            }else if(inTemp != setTemp){
                 if(inTemp > setTemp){
                     climaState = STATE_ON_COOL;
                 }else{
@@ -41,6 +41,8 @@
 void setIODIR(char, char);
 void setGPIO(char, char);
 void lcdCommand(char);
+void lcdData(unsigned char);
+unsigned char lcdCell(unsigned char addr);
 
 void LcdInit(void);
 void LcdClear(void);
@@ -49,6 +51,20 @@ void LcdChar(unsigned char letter);
 void LcdWriteString(const char *s);
 
 
+/* shadow of the 32 visible cells, LcdChar() sends only the cells that change
+ * and moves the controller address only when a cell is skipped, so a whole
+ * screen is rewritten in place without LcdClear() (1.52ms and a blank frame)
+ */
+#define LCD_COLS        16
+#define LCD_ROWS        2
+#define LCD_LINE2       0x40    /* DDRAM address of the second line */
+#define LCD_ADDR_NONE   0xFF    /* not a visible cell */
+
+unsigned char lcdShadow[LCD_ROWS * LCD_COLS];   /* what the display shows */
+unsigned char lcdAddr = 0;      /* DDRAM address of the next LcdChar() */
+unsigned char lcdHwAddr = 0;    /* address counter of the controller */
+
+
 /*
  * used to set the values of the ports ( think of it as when you use a PORT register)
  */
@@ -112,6 +128,38 @@ void lcdCommand(char command)
 }
 
 
+/*******************************************************************************
+ * Data Function
+ *  - one byte to DDRAM at the controller address, no shadow
+ */
+void lcdData(unsigned char value)
+{
+    setGPIO(GPIOA_ADDRESS,0x80); // RS=1, we going to send data to be displayed
+    //Delay10TCYx(0); // let things settle down
+    setGPIO(GPIOB_ADDRESS,value); // send display character
+    // Now we need to toggle the enable pin (EN) for the display to take effect
+    setGPIO(GPIOA_ADDRESS, 0xc0); // RS=1, EN=1
+    //Delay10TCYx(0); // let things settle down, this time just needs to be long enough for the chip to detect it as high
+    setGPIO(GPIOA_ADDRESS,0x00); // RS=0, EN=0 // this completes the enable pin toggle
+    //Delay10TCYx(0);
+} /* void lcdData(unsigned char value) */
+
+
+/*******************************************************************************
+ * Cell Function
+ *  - DDRAM address => index in lcdShadow, LCD_ADDR_NONE past the 16 columns
+ */
+unsigned char lcdCell(unsigned char addr)
+{
+    unsigned char col = addr & ~LCD_LINE2;
+
+    if (col >= LCD_COLS)
+        return LCD_ADDR_NONE;
+
+    return (addr & LCD_LINE2) ? (col + LCD_COLS) : col;
+} /* unsigned char lcdCell(unsigned char addr) */
+
+
 /*******************************************************************************
  * PUBLIC FUNCTIONs                                                        BEGIN
  */
@@ -144,8 +192,8 @@ void LcdInit(void)
     // NO Cursor, NO blicking
     lcdCommand(0b00001100);
 
-    // clear display
-    lcdCommand(0b00000001);
+    // clear display, blank shadow
+    LcdClear();
 
     // entry mode
     lcdCommand(0b00000110);
@@ -165,8 +213,15 @@ void LcdInit(void)
  */
 void LcdClear(void)
 {
+    unsigned char i;
+
     /* clear display */
     lcdCommand(0x01);
+
+    for (i = 0; i < LCD_ROWS * LCD_COLS; i++)
+        lcdShadow[i] = ' ';
+    lcdAddr = 0;
+    lcdHwAddr = 0;
 } /* void LcdClear(void) */
 
 
@@ -175,8 +230,8 @@ void LcdClear(void)
  */
 void LcdGoTo(char pos)
 {
-    // add 0x80 to be able to use HD44780 position convention
-    lcdCommand(0x80+pos);
+    // only remembered, LcdChar() sends the address if a cell has to change
+    lcdAddr = pos;
 }
 
 
@@ -185,14 +240,25 @@ void LcdGoTo(char pos)
  */
 void LcdChar(unsigned char letter)
 {
-    setGPIO(GPIOA_ADDRESS,0x80); // RS=1, we going to send data to be displayed
-    //Delay10TCYx(0); // let things settle down
-    setGPIO(GPIOB_ADDRESS,letter); // send display character
-    // Now we need to toggle the enable pin (EN) for the display to take effect
-    setGPIO(GPIOA_ADDRESS, 0xc0); // RS=1, EN=1
-    //Delay10TCYx(0); // let things settle down, this time just needs to be long enough for the chip to detect it as high
-    setGPIO(GPIOA_ADDRESS,0x00); // RS=0, EN=0 // this completes the enable pin toggle
-    //Delay10TCYx(0);
+    unsigned char cell = lcdCell(lcdAddr);
+
+    if ((cell != LCD_ADDR_NONE) && (lcdShadow[cell] == letter))
+    {
+        lcdAddr++; // already on the display
+        return;
+    }
+
+    if (lcdHwAddr != lcdAddr)
+    {
+        // add 0x80 to be able to use HD44780 position convention
+        lcdCommand(0x80+lcdAddr);
+    }
+    lcdData(letter);
+
+    if (cell != LCD_ADDR_NONE)
+        lcdShadow[cell] = letter;
+    lcdAddr++;
+    lcdHwAddr = lcdAddr;
 } /* void LcdChar(unsigned char letter) */
 
 